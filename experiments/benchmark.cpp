@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 
@@ -5,6 +6,8 @@
 #include "base/environments/GridMaze.h"
 #include "planners/OMPLControlPlanner.hpp"
 #include "planners/OMPLPlanner.hpp"
+#include "planners/hybrid_astar/HybridAStar.h"
+#include "planners/jps/JumpPointSearch.h"
 #include "planners/sbpl/SbplPlanner.h"
 #include "planners/thetastar/ThetaStar.h"
 #include "utils/PathEvaluation.hpp"
@@ -79,6 +82,10 @@ void evaluatePlanners(nlohmann::json &info) {
     PathEvaluation::evaluateSmoothers<PDSTPlanner>(info);
   if (global::settings.benchmark.planning.theta_star)
     PathEvaluation::evaluateSmoothers<ThetaStar>(info);
+  if (global::settings.benchmark.planning.jps)
+    PathEvaluation::evaluateSmoothers<JumpPointSearch>(info);
+  if (global::settings.benchmark.planning.hybrid_astar)
+    PathEvaluation::evaluateSmoothers<HybridAStar>(info);
 }
 
 void run(nlohmann::json &info) {
@@ -124,6 +131,81 @@ void config_steering_and_run(std::size_t run_id, std::size_t start_id,
   }
 }
 
+/**
+ * Runs the given Moving AI scenarios grouped by their map. The grid (including
+ * its distance field), the collision model and the state space of every steer
+ * function are set up once per map; between the scenarios of one map only
+ * start and goal are updated.
+ */
+void run_moving_ai_batch(ScenarioLoader &scenarioLoader,
+                         const std::vector<std::size_t> &ids) {
+  // group scenarios by map, maintaining the order in which maps appear
+  std::vector<std::pair<std::string, std::vector<std::size_t>>> groups;
+  for (const auto id : ids) {
+    const auto &map_name = scenarioLoader.scenarios()[id].mapName;
+    auto group = std::find_if(
+        groups.begin(), groups.end(),
+        [&map_name](const auto &g) { return g.first == map_name; });
+    if (group == groups.end())
+      groups.emplace_back(map_name, std::vector<std::size_t>{id});
+    else
+      group->second.push_back(id);
+  }
+
+  global::settings.env.collision.initializeCollisionModel();
+
+  std::size_t counter = 0;
+  for (const auto &entry : groups) {
+    const auto &map_name = entry.first;
+    const auto &group = entry.second;
+    std::cout << "##############################################"
+              << std::endl;
+    std::cout << "# Moving AI Map " << map_name << "  (" << group.size()
+              << " scenarios)" << std::endl;
+    std::cout << "##############################################"
+              << std::endl;
+
+    auto grid = GridMaze::createFromMovingAiScenario(
+        scenarioLoader.scenarios()[group.front()]);
+    global::settings.environment = grid;
+
+    const auto run_group = [&]() {
+      for (const auto id : group) {
+        auto &scenario = scenarioLoader.scenarios()[id];
+        std::cout << "# Moving AI Scenario " << id << "  (" << ++counter << "/"
+                  << ids.size() << ")" << std::endl;
+        grid->setMovingAiScenario(scenario);
+        if (global::settings.benchmark.log_file.value().empty())
+          global::settings.benchmark.log_file = Log::filename() + ".json";
+        auto info =
+            nlohmann::json({{"optimalDistance", scenario.optimal_length}});
+        run(info);
+      }
+    };
+
+    if (global::settings.benchmark.control_planners_on) {
+      for (const auto forward_propagation_type :
+           global::settings.benchmark.forward_propagations.value()) {
+        global::settings.forwardpropagation.forward_propagation_type =
+            forward_propagation_type;
+        global::settings.forwardpropagation.initializeForwardPropagation();
+        run_group();
+      }
+    } else if (global::settings.benchmark.steer_functions.value().empty()) {
+      global::settings.steer.initializeSteering();
+      run_group();
+    } else {
+      for (const auto steer_type :
+           global::settings.benchmark.steer_functions.value()) {
+        global::settings.steer.steering_type = steer_type;
+        global::settings.steer.initializeSteering();
+        run_group();
+      }
+    }
+    Log::save(global::settings.benchmark.log_file);
+  }
+}
+
 int main(int argc, char **argv) {
   std::string template_filename = "benchmark_template.json";
   std::ofstream o(template_filename);
@@ -153,6 +235,14 @@ int main(int argc, char **argv) {
     const auto n = scenarioLoader.scenarios().size();
     std::size_t start_id = (global::settings.benchmark.moving_ai.start + n) % n;
     std::size_t end_id = (global::settings.benchmark.moving_ai.end + n) % n;
+    if (global::settings.benchmark.moving_ai.batch) {
+      std::vector<std::size_t> ids;
+      for (int i = global::settings.benchmark.moving_ai.start;
+           i < global::settings.benchmark.moving_ai.end; ++i)
+        ids.push_back((i + n) % n);
+      run_moving_ai_batch(scenarioLoader, ids);
+      return EXIT_SUCCESS;
+    }
     for (int i = global::settings.benchmark.moving_ai.start;
          i < global::settings.benchmark.moving_ai.end; ++i) {
       std::size_t id = (i + n) % n;
@@ -0,0 +1,380 @@
+#include <benchmark/benchmark.h>
+#include <ompl/base/SpaceInformation.h>
+#include <ompl/base/spaces/SE2StateSpace.h>
+#include <ompl/control/SpaceInformation.h>
+#include <ompl/control/spaces/RealVectorControlSpace.h>
+#include <ompl/util/RandomNumbers.h>
+
+#include <map>
+#include <memory>
+#include <random>
+
+#include "base/PlannerSettings.h"
+#include "base/environments/GridMaze.h"
+#include "base/environments/PolygonMaze.h"
+#include "fp_models/kinematic_car/kinematic_car.hpp"
+#include "metrics/AOLMetric.h"
+#include "metrics/ClearingMetric.h"
+#include "metrics/MaxCurvatureMetric.h"
+#include "metrics/NormalizedCurvatureMetric.h"
+#include "metrics/PathLengthMetric.h"
+
+namespace ob = ompl::base;
+namespace oc = ompl::control;
+namespace og = ompl::geometric;
+
+namespace {
+// number of precomputed queries cycled through by the benchmarks
+const std::size_t Queries = 4096;
+const unsigned int Seed = 1;
+
+/**
+ * Random grid maze of the given size, created once with a fixed seed and its
+ * distance field computed.
+ */
+std::shared_ptr<GridMaze> grid(unsigned int size) {
+  static std::map<unsigned int, std::shared_ptr<GridMaze>> grids;
+  auto &maze = grids[size];
+  if (!maze) {
+    maze = GridMaze::createRandom(size, size, 0.3, Seed + size);
+    maze->computeDistances();
+  }
+  return maze;
+}
+
+/**
+ * Polygon maze of size / 2 randomly placed and rotated boxes within
+ * [0, size]^2, created once with a fixed seed.
+ */
+std::shared_ptr<PolygonMaze> polygonMaze(unsigned int size) {
+  static std::map<unsigned int, std::shared_ptr<PolygonMaze>> mazes;
+  auto &maze = mazes[size];
+  if (!maze) {
+    std::mt19937 rng(Seed + size);
+    std::uniform_real_distribution<double> position(0, size), extent(1, 3),
+        angle(-M_PI, M_PI);
+    std::vector<Polygon> obstacles;
+    for (unsigned int i = 0; i < size / 2; ++i) {
+      const double x = position(rng), y = position(rng), a = angle(rng);
+      const double w = extent(rng), h = extent(rng);
+      Polygon box;
+      for (const auto &corner : {Point(-w, -h), Point(w, -h), Point(w, h),
+                                 Point(-w, h)}) {
+        box.points.emplace_back(
+            x + corner.x * std::cos(a) - corner.y * std::sin(a),
+            y + corner.x * std::sin(a) + corner.y * std::cos(a));
+      }
+      obstacles.push_back(box);
+    }
+    maze = PolygonMaze::createFromObstacles(obstacles);
+  }
+  return maze;
+}
+
+std::vector<Point> randomPoints(double size, std::size_t count = Queries) {
+  std::mt19937 rng(Seed);
+  std::uniform_real_distribution<double> position(0, size);
+  std::vector<Point> points;
+  for (std::size_t i = 0; i < count; ++i)
+    points.emplace_back(position(rng), position(rng));
+  return points;
+}
+
+/**
+ * Rectangular 2x1 footprints at random positions and orientations.
+ */
+std::vector<Polygon> randomFootprints(double size) {
+  std::mt19937 rng(Seed);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::vector<Polygon> footprints;
+  for (const auto &p : randomPoints(size)) {
+    const double a = angle(rng);
+    Polygon footprint;
+    for (const auto &corner : {Point(-1, -.5), Point(1, -.5), Point(1, .5),
+                               Point(-1, .5)}) {
+      footprint.points.emplace_back(
+          p.x + corner.x * std::cos(a) - corner.y * std::sin(a),
+          p.y + corner.x * std::sin(a) + corner.y * std::cos(a));
+    }
+    footprints.push_back(footprint);
+  }
+  return footprints;
+}
+
+void GridSizes(benchmark::internal::Benchmark *b) {
+  for (int size : {50, 100, 200}) b->Arg(size);
+}
+}  // namespace
+
+static void BM_GridMaze_Occupied(benchmark::State &state) {
+  auto maze = grid(state.range(0));
+  const auto points = randomPoints(state.range(0));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto &p = points[i++ % Queries];
+    benchmark::DoNotOptimize(maze->occupied(p.x, p.y));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GridMaze_Occupied)->Apply(GridSizes);
+
+static void BM_GridMaze_CollidesPolygon(benchmark::State &state) {
+  auto maze = grid(state.range(0));
+  const auto footprints = randomFootprints(state.range(0));
+  std::size_t i = 0;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(maze->collides(footprints[i++ % Queries]));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GridMaze_CollidesPolygon)->Apply(GridSizes);
+
+static void BM_PolygonMaze_CollidesPoint(benchmark::State &state) {
+  auto maze = polygonMaze(state.range(0));
+  const auto points = randomPoints(state.range(0));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto &p = points[i++ % Queries];
+    benchmark::DoNotOptimize(maze->collides(p.x, p.y));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PolygonMaze_CollidesPoint)->Apply(GridSizes);
+
+static void BM_PolygonMaze_CollidesPolygon(benchmark::State &state) {
+  auto maze = polygonMaze(state.range(0));
+  const auto footprints = randomFootprints(state.range(0));
+  std::size_t i = 0;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(maze->collides(footprints[i++ % Queries]));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PolygonMaze_CollidesPolygon)->Apply(GridSizes);
+
+/**
+ * Computes the distance field with the method given by the first argument on
+ * a grid of the size given by the second argument.
+ */
+static void BM_GridMaze_ComputeDistances(benchmark::State &state) {
+  const auto method = (distance_computation::Method)state.range(0);
+  const bool cached_auto =
+      global::settings.auto_choose_distance_computation_method;
+  const auto cached_method = global::settings.distance_computation_method;
+  global::settings.auto_choose_distance_computation_method = false;
+  global::settings.distance_computation_method = method;
+  state.SetLabel(distance_computation::to_string(method));
+  GridMaze maze(*grid(state.range(1)));
+  for (auto _ : state) maze.computeDistances();
+  state.SetItemsProcessed(state.iterations() * maze.cells());
+  global::settings.auto_choose_distance_computation_method = cached_auto;
+  global::settings.distance_computation_method = cached_method;
+}
+// brute force is quadratic in the number of cells
+BENCHMARK(BM_GridMaze_ComputeDistances)
+    ->Args({distance_computation::BRUTE_FORCE, 50})
+    ->Args({distance_computation::BRUTE_FORCE, 100})
+    ->Args({distance_computation::DEAD_RECKONING, 50})
+    ->Args({distance_computation::DEAD_RECKONING, 100})
+    ->Args({distance_computation::DEAD_RECKONING, 200})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_BilinearDistance(benchmark::State &state) {
+  auto maze = grid(state.range(0));
+  const auto points = randomPoints(state.range(0));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto &p = points[i++ % Queries];
+    benchmark::DoNotOptimize(maze->bilinearDistance(p.x, p.y));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BilinearDistance)->Apply(GridSizes);
+
+static void BM_DistanceGradient(benchmark::State &state) {
+  auto maze = grid(state.range(0));
+  const auto points = randomPoints(state.range(0));
+  std::size_t i = 0;
+  double dx, dy;
+  for (auto _ : state) {
+    const auto &p = points[i++ % Queries];
+    benchmark::DoNotOptimize(maze->distanceGradient(p.x, p.y, dx, dy));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DistanceGradient)->Apply(GridSizes);
+
+/**
+ * Random state pairs in the state space of the steer function given by the
+ * first argument, with the 50x50 grid as environment.
+ */
+class SteerFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State &state) override {
+    global::settings.environment = grid(50);
+    global::settings.steer.steering_type =
+        (Steering::SteeringType)state.range(0);
+    global::settings.steer.initializeSteering();
+    space = global::settings.ompl.state_space;
+    std::mt19937 rng(Seed);
+    std::uniform_real_distribution<double> position(0, 50),
+        angle(-M_PI, M_PI);
+    // initializes additional state components (e.g. curvature)
+    auto sampler = space->allocDefaultStateSampler();
+    for (std::size_t i = 0; i < Queries; ++i) {
+      from.push_back(space->allocState());
+      to.push_back(space->allocState());
+      for (auto *s : {from.back(), to.back()}) {
+        sampler->sampleUniform(s);
+        auto *se2 = s->as<ob::SE2StateSpace::StateType>();
+        se2->setXY(position(rng), position(rng));
+        se2->setYaw(angle(rng));
+      }
+    }
+    result = space->allocState();
+  }
+
+  void TearDown(const benchmark::State &) override {
+    for (auto *s : from) space->freeState(s);
+    for (auto *s : to) space->freeState(s);
+    space->freeState(result);
+    from.clear();
+    to.clear();
+  }
+
+  ob::StateSpacePtr space;
+  std::vector<ob::State *> from, to;
+  ob::State *result{nullptr};
+};
+
+BENCHMARK_DEFINE_F(SteerFixture, Distance)(benchmark::State &state) {
+  state.SetLabel(Steering::to_string(global::settings.steer.steering_type));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t k = i++ % Queries;
+    benchmark::DoNotOptimize(space->distance(from[k], to[k]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(SteerFixture, Interpolate)(benchmark::State &state) {
+  state.SetLabel(Steering::to_string(global::settings.steer.steering_type));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t k = i++ % Queries;
+    space->interpolate(from[k], to[k], .5, result);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void SteerFunctions(benchmark::internal::Benchmark *b) {
+  for (auto type :
+       {Steering::STEER_TYPE_REEDS_SHEPP, Steering::STEER_TYPE_DUBINS,
+        Steering::STEER_TYPE_POSQ, Steering::STEER_TYPE_LINEAR,
+        Steering::STEER_TYPE_CC_DUBINS, Steering::STEER_TYPE_HC_REEDS_SHEPP,
+        Steering::STEER_TYPE_CC_REEDS_SHEPP})
+    b->Arg(type);
+#ifdef G1_AVAILABLE
+  b->Arg(Steering::STEER_TYPE_CLOTHOID);
+#endif
+}
+BENCHMARK_REGISTER_F(SteerFixture, Distance)->Apply(SteerFunctions);
+BENCHMARK_REGISTER_F(SteerFixture, Interpolate)->Apply(SteerFunctions);
+
+static void BM_KinematicCar_Propagate(benchmark::State &state) {
+  auto space = std::make_shared<ob::SE2StateSpace>();
+  ob::RealVectorBounds workspace(2);
+  workspace.setLow(0);
+  workspace.setHigh(50);
+  space->setBounds(workspace);
+  auto controls = std::make_shared<oc::RealVectorControlSpace>(space, 2);
+  ob::RealVectorBounds control_bounds(2);
+  control_bounds.setLow(-1.5);
+  control_bounds.setHigh(1.5);
+  controls->setBounds(control_bounds);
+  auto si = std::make_shared<oc::SpaceInformation>(space, controls);
+  si->setup();
+
+  std::mt19937 rng(Seed);
+  std::uniform_real_distribution<double> position(0, 50), angle(-M_PI, M_PI),
+      control(-1.5, 1.5);
+  std::vector<ob::State *> from(Queries);
+  std::vector<oc::Control *> u(Queries);
+  for (std::size_t i = 0; i < Queries; ++i) {
+    from[i] = si->allocState();
+    auto *se2 = from[i]->as<ob::SE2StateSpace::StateType>();
+    se2->setXY(position(rng), position(rng));
+    se2->setYaw(angle(rng));
+    u[i] = si->allocControl();
+    auto *values = u[i]->as<oc::RealVectorControlSpace::ControlType>()->values;
+    values[0] = control(rng);
+    values[1] = control(rng);
+  }
+  auto *result = si->allocState();
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t k = i++ % Queries;
+    KinematicCar::propagate(si.get(), from[k], u[k], 1., result);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  for (std::size_t k = 0; k < Queries; ++k) {
+    si->freeState(from[k]);
+    si->freeControl(u[k]);
+  }
+  si->freeState(result);
+}
+BENCHMARK(BM_KinematicCar_Propagate);
+
+/**
+ * Evaluates the metric on a fixed sinusoidal path with ten states per unit
+ * of the size given by the argument across the grid of that size.
+ */
+template <class METRIC>
+static void BM_Metric(benchmark::State &state) {
+  const unsigned int size = state.range(0);
+  global::settings.environment = grid(size);
+  auto space = std::make_shared<ob::SE2StateSpace>();
+  space->setBounds(global::settings.environment->bounds());
+  auto si = std::make_shared<ob::SpaceInformation>(space);
+  og::PathGeometric path(si);
+  auto *s = space->allocState();
+  for (unsigned int i = 0; i < 10 * size; ++i) {
+    const double x = 1. + i * (size - 2.) / (10. * size);
+    auto *se2 = s->as<ob::SE2StateSpace::StateType>();
+    se2->setXY(x, size / 2. + size / 4. * std::sin(x / 5.));
+    se2->setYaw(std::atan(size / 20. * std::cos(x / 5.)));
+    path.append(s);
+  }
+  space->freeState(s);
+  for (auto _ : state) benchmark::DoNotOptimize(METRIC::evaluate(path));
+  state.SetItemsProcessed(state.iterations() * path.getStateCount());
+}
+BENCHMARK_TEMPLATE(BM_Metric, PathLengthMetric)->Apply(GridSizes);
+BENCHMARK_TEMPLATE(BM_Metric, ClearingMetric)->Apply(GridSizes);
+BENCHMARK_TEMPLATE(BM_Metric, MaxCurvatureMetric)->Apply(GridSizes);
+BENCHMARK_TEMPLATE(BM_Metric, NormalizedCurvatureMetric)->Apply(GridSizes);
+BENCHMARK_TEMPLATE(BM_Metric, AOLMetric)->Apply(GridSizes);
+
+/**
+ * Microbenchmarks of the core kernels (collision checks, distance fields,
+ * steer functions, forward propagation and metrics) on fixed seeded maps of
+ * several sizes. Accepts the Google Benchmark options, e.g.
+ *
+ *   mpb_microbench --benchmark_repetitions=10 \
+ *       --benchmark_out=microbench.json --benchmark_out_format=json
+ *
+ * The JSON output can be compared against a baseline via
+ * python/compare_microbench.py.
+ */
+int main(int argc, char **argv) {
+  // computeDistances() and the environment generators are verbose
+  ompl::msg::setLogLevel(ompl::msg::LOG_WARN);
+  ompl::RNG::setSeed(Seed);
+  global::settings.steer.interpolation_cache.enabled = false;
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/base/spaces/SE2StateSpace.h>
+#include <ompl/control/ODESolver.h>
+#include <ompl/control/SpaceInformation.h>
+#include <ompl/control/spaces/RealVectorControlSpace.h>
+
+#include <fstream>
+#include <iomanip>
+
+#include "base/PlannerSettings.h"
+#include "fp_models/kinematic_car/kinematic_car.hpp"
+#include "fp_models/kinematic_single_track/kinematic_single_track.hpp"
+#include "utils/Stopwatch.hpp"
+
+namespace ob = ompl::base;
+namespace oc = ompl::control;
+
+typedef void (*Propagator)(const oc::SpaceInformation *, const ob::State *,
+                           const oc::Control *, const double, ob::State *);
+
+/**
+ * Propagates random states with random controls using OMPL's ODE solver and
+ * the given propagator and reports the throughput of both and the largest
+ * position and heading deviation between them.
+ */
+nlohmann::json compare(const oc::SpaceInformationPtr &si,
+                       const oc::ODESolver::ODE &ode,
+                       const oc::ODESolver::PostPropagationEvent &post,
+                       Propagator propagator, std::size_t samples,
+                       double duration) {
+  // the single-track state is a compound of SE(2) and the velocity states
+  const bool is_se2 =
+      dynamic_cast<const ob::SE2StateSpace *>(si->getStateSpace().get());
+  const auto se2 = [is_se2](const ob::State *state) {
+    if (is_se2) return state->as<ob::SE2StateSpace::StateType>();
+    return state->as<ob::CompoundStateSpace::StateType>()
+        ->as<ob::SE2StateSpace::StateType>(0);
+  };
+
+  auto sampler = si->allocStateSampler();
+  auto control_sampler = si->allocControlSampler();
+  std::vector<ob::State *> from(samples), ode_result(samples),
+      result(samples);
+  std::vector<oc::Control *> controls(samples);
+  for (std::size_t i = 0; i < samples; ++i) {
+    from[i] = si->allocState();
+    ode_result[i] = si->allocState();
+    result[i] = si->allocState();
+    controls[i] = si->allocControl();
+    sampler->sampleUniform(from[i]);
+    control_sampler->sample(controls[i]);
+  }
+
+  auto solver = std::make_shared<oc::ODEBasicSolver<>>(si, ode);
+  const auto ode_propagator = oc::ODESolver::getStatePropagator(solver, post);
+  Stopwatch watch;
+  watch.start();
+  for (std::size_t i = 0; i < samples; ++i)
+    ode_propagator->propagate(from[i], controls[i], duration, ode_result[i]);
+  const double ode_time = watch.stop();
+
+  watch.start();
+  for (std::size_t i = 0; i < samples; ++i)
+    propagator(si.get(), from[i], controls[i], duration, result[i]);
+  const double time = watch.stop();
+
+  double max_position_error = 0, max_yaw_error = 0;
+  for (std::size_t i = 0; i < samples; ++i) {
+    const auto *a = se2(ode_result[i]), *b = se2(result[i]);
+    max_position_error =
+        std::max(max_position_error,
+                 std::hypot(a->getX() - b->getX(), a->getY() - b->getY()));
+    max_yaw_error = std::max(
+        max_yaw_error, std::abs(ForwardPropagation::normalizeYaw(
+                           a->getYaw() - b->getYaw())));
+    si->freeState(from[i]);
+    si->freeState(ode_result[i]);
+    si->freeState(result[i]);
+    si->freeControl(controls[i]);
+  }
+
+  nlohmann::json report;
+  report["ode_propagations_per_sec"] = samples / ode_time;
+  report["propagations_per_sec"] = samples / time;
+  report["speedup"] = ode_time / time;
+  report["max_position_deviation"] = max_position_error;
+  report["max_yaw_deviation"] = max_yaw_error;
+  return report;
+}
+
+/**
+ * Measures the throughput of the forward propagation models used by the
+ * control-based planners against the previously used ODE solver, and the
+ * deviation between both. The results are written to
+ * propagation_benchmark.json.
+ *
+ * Usage: propagation_benchmark [samples] [duration]
+ */
+int main(int argc, char **argv) {
+  const std::size_t samples = argc > 1 ? std::stoul(argv[1]) : 100000;
+  const double duration = argc > 2 ? std::stod(argv[2]) : 1.;
+
+  ob::RealVectorBounds workspace(2);
+  workspace.setLow(0);
+  workspace.setHigh(50);
+  ob::RealVectorBounds control_bounds(2);
+  control_bounds.setLow(-1.5);
+  control_bounds.setHigh(1.5);
+
+  nlohmann::json report;
+  report["samples"] = samples;
+  report["duration"] = duration;
+  report["dt"] = global::settings.forwardpropagation.dt.value();
+  report["car_length"] = global::settings.forwardpropagation.car_length.value();
+
+  {
+    auto space = std::make_shared<ob::SE2StateSpace>();
+    space->setBounds(workspace);
+    auto controls = std::make_shared<oc::RealVectorControlSpace>(space, 2);
+    controls->setBounds(control_bounds);
+    auto si = std::make_shared<oc::SpaceInformation>(space, controls);
+    report["KinematicCar"] =
+        compare(si, &KinematicCar::kinematicCarODE,
+                &KinematicCar::kinematicCarPostIntegration,
+                &KinematicCar::propagate, samples, duration);
+  }
+  {
+    auto space = std::make_shared<ob::CompoundStateSpace>();
+    auto se2 = std::make_shared<ob::SE2StateSpace>();
+    se2->setBounds(workspace);
+    auto real = std::make_shared<ob::RealVectorStateSpace>(2);
+    real->setBounds(control_bounds);
+    space->addSubspace(se2, 1.);
+    space->addSubspace(real, 1.);
+    auto controls = std::make_shared<oc::RealVectorControlSpace>(space, 2);
+    controls->setBounds(control_bounds);
+    auto si = std::make_shared<oc::SpaceInformation>(space, controls);
+    report["KinematicSingleTrack"] = compare(
+        si, &kinematicSingleTrack::kinematicSingleTrackODE,
+        &kinematicSingleTrack::kinematicSingleTrackPostIntegration,
+        &kinematicSingleTrack::propagate, samples, duration);
+  }
+
+  std::ofstream file("propagation_benchmark.json");
+  file << std::setw(2) << report << std::endl;
+  std::cout << std::setw(2) << report << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include <ompl/base/ScopedState.h>
+#include <ompl/base/spaces/DubinsStateSpace.h>
+#include <ompl/base/spaces/ReedsSheppStateSpace.h>
+#include <ompl/util/RandomNumbers.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "base/PlannerSettings.h"
+#include "steer_functions/SteerDistanceTable.h"
+#include "utils/Stopwatch.hpp"
+
+namespace ob = ompl::base;
+
+/**
+ * Compares the Reeds-Shepp and Dubins distance tables against the analytic
+ * solvers in terms of accuracy and throughput. Random state pairs are sampled
+ * within the given workspace size, the results are written to
+ * steer_distance_table.json.
+ *
+ * Usage: steer_distance_table [samples] [workspace size]
+ */
+int main(int argc, char **argv) {
+  const std::size_t samples = argc > 1 ? std::stoul(argv[1]) : 200000;
+  const double size = argc > 2 ? std::stod(argv[2]) : 50.;
+  const double radius = global::settings.steer.car_turning_radius;
+  const auto &table_settings = global::settings.steer.distance_table;
+
+  nlohmann::json report;
+  report["samples"] = samples;
+  report["workspace_size"] = size;
+  report["turning_radius"] = radius;
+  report["extent"] = table_settings.extent.value();
+  report["cells_xy"] = table_settings.cells_xy.value();
+  report["cells_theta"] = table_settings.cells_theta.value();
+  report["max_cell_spread"] = table_settings.max_cell_spread.value();
+
+  for (const auto type :
+       {Steering::STEER_TYPE_REEDS_SHEPP, Steering::STEER_TYPE_DUBINS}) {
+    Stopwatch watch;
+    watch.start();
+    const auto table = SteerDistanceTable::loadOrGenerate(
+        type, table_settings.extent, table_settings.cells_xy,
+        table_settings.cells_theta, table_settings.max_cell_spread,
+        table_settings.cache_dir);
+    const double setup_time = watch.stop();
+
+    ob::StateSpacePtr space;
+    if (type == Steering::STEER_TYPE_DUBINS)
+      space = std::make_shared<ob::DubinsStateSpace>(radius);
+    else
+      space = std::make_shared<ob::ReedsSheppStateSpace>(radius);
+
+    ompl::RNG rng;
+    std::vector<ob::State *> from(samples), to(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+      from[i] = space->allocState();
+      to[i] = space->allocState();
+      for (auto *state : {from[i], to[i]}) {
+        auto *s = state->as<ob::SE2StateSpace::StateType>();
+        s->setXY(rng.uniformReal(0, size), rng.uniformReal(0, size));
+        s->setYaw(rng.uniformReal(-M_PI, M_PI));
+      }
+    }
+
+    std::vector<double> exact(samples), approx(samples);
+    watch.start();
+    for (std::size_t i = 0; i < samples; ++i)
+      exact[i] = space->distance(from[i], to[i]);
+    const double exact_time = watch.stop();
+
+    std::size_t fallbacks = 0;
+    watch.start();
+    for (std::size_t i = 0; i < samples; ++i) {
+      double d = table->distance(from[i], to[i], radius);
+      if (d < 0) {
+        d = space->distance(from[i], to[i]);
+        ++fallbacks;
+      }
+      approx[i] = d;
+    }
+    const double table_time = watch.stop();
+
+    std::vector<double> errors(samples);
+    double error_sum = 0, relative_error_sum = 0;
+    for (std::size_t i = 0; i < samples; ++i) {
+      errors[i] = std::abs(approx[i] - exact[i]);
+      error_sum += errors[i];
+      if (exact[i] > 1e-9) relative_error_sum += errors[i] / exact[i];
+    }
+    std::sort(errors.begin(), errors.end());
+
+    nlohmann::json &result = report[Steering::to_string(type)];
+    result["setup_time"] = setup_time;
+    result["invalid_cell_ratio"] = table->invalidCellRatio();
+    result["fallback_ratio"] = (double)fallbacks / samples;
+    result["mean_abs_error"] = error_sum / samples;
+    result["mean_rel_error"] = relative_error_sum / samples;
+    result["p99_abs_error"] = errors[(std::size_t)(0.99 * (samples - 1))];
+    result["max_abs_error"] = errors.back();
+    result["exact_evaluations_per_sec"] = samples / exact_time;
+    result["table_evaluations_per_sec"] = samples / table_time;
+    result["speedup"] = exact_time / table_time;
+
+    OMPL_INFORM(
+        "%s: mean error %.4f, max error %.4f, %.2f%% fallbacks, %.1fx faster",
+        Steering::to_string(type).c_str(), error_sum / samples,
+        errors.back(), 100. * fallbacks / samples, exact_time / table_time);
+
+    for (std::size_t i = 0; i < samples; ++i) {
+      space->freeState(from[i]);
+      space->freeState(to[i]);
+    }
+  }
+
+  std::ofstream file("steer_distance_table.json");
+  file << std::setw(2) << report << std::endl;
+  std::cout << std::setw(2) << report << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Compares the JSON output of mpb_microbench (Google Benchmark format) against
+a stored baseline and flags regressions. Exits with status 1 if any benchmark
+regressed, so that it can gate performance patches.
+
+Usage:
+    mpb_microbench --benchmark_repetitions=10 \\
+        --benchmark_out=current.json --benchmark_out_format=json
+    python3 compare_microbench.py baseline.json current.json
+"""
+import json
+import math
+import sys
+from collections import OrderedDict
+
+import click
+
+TIME_UNITS = {"ns": 1., "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(filename: str, metric: str):
+    """
+    Returns the times (in nanoseconds) of all repetitions per benchmark,
+    ignoring the aggregates computed by Google Benchmark.
+    """
+    with open(filename, "r") as f:
+        data = json.load(f)
+    times = OrderedDict()
+    for b in data["benchmarks"]:
+        if b.get("run_type", "iteration") != "iteration" or "error_occurred" in b:
+            continue
+        name = b.get("run_name", b["name"])
+        if b.get("label"):
+            name += " (%s)" % b["label"]
+        times.setdefault(name, []).append(b[metric] * TIME_UNITS[b.get("time_unit", "ns")])
+    return times
+
+
+def median(xs):
+    xs = sorted(xs)
+    n = len(xs)
+    return xs[n // 2] if n % 2 else 0.5 * (xs[n // 2 - 1] + xs[n // 2])
+
+
+def mann_whitney_p(baseline, current):
+    """
+    One-sided p-value of the Mann-Whitney U test (normal approximation) for
+    the hypothesis that the current times are greater than the baseline.
+    """
+    n1, n2 = len(baseline), len(current)
+    u = 0.
+    for c in current:
+        for b in baseline:
+            u += 1. if c > b else 0.5 if c == b else 0.
+    mean = n1 * n2 / 2.
+    std = math.sqrt(n1 * n2 * (n1 + n2 + 1) / 12.)
+    if std == 0:
+        return 1.
+    z = (u - mean) / std
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+@click.command()
+@click.argument('baseline_file', type=click.Path(exists=True))
+@click.argument('current_file', type=click.Path(exists=True))
+@click.option('--threshold', default=0.05, type=float,
+              help='Relative slowdown of the median time that counts as a regression.')
+@click.option('--alpha', default=0.05, type=float,
+              help='Significance level of the Mann-Whitney U test if at least 3 repetitions are available.')
+@click.option('--metric', default='real_time', type=click.Choice(['real_time', 'cpu_time']))
+def main(baseline_file: str, current_file: str, threshold: float, alpha: float, metric: str):
+    baseline = load_times(baseline_file, metric)
+    current = load_times(current_file, metric)
+    regressions = 0
+    click.echo("%-60s %12s %12s %8s %8s" % ("Benchmark", "Baseline", "Current", "Change", "p"))
+    for name, times in current.items():
+        if name not in baseline:
+            click.echo("%-60s %12s %12.1f %8s" % (name, "-", median(times), "new"))
+            continue
+        base = baseline[name]
+        ratio = median(times) / median(base) - 1.
+        significant = True
+        p = float('nan')
+        if len(times) >= 3 and len(base) >= 3:
+            p = mann_whitney_p(base, times) if ratio > 0 else mann_whitney_p(times, base)
+            significant = p < alpha
+        status = ""
+        if significant and ratio > threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif significant and ratio < -threshold:
+            status = "improvement"
+        click.echo("%-60s %12.1f %12.1f %+7.1f%% %8.3f %s" % (
+            name, median(base), median(times), 100. * ratio, p, status))
+    for name in baseline:
+        if name not in current:
+            click.echo("%-60s %12.1f %12s %8s" % (name, median(baseline[name]), "-", "missing"))
+    click.echo("Times in nanoseconds (median over repetitions).")
+    if regressions > 0:
+        click.echo("%i benchmark(s) regressed by more than %.1f%%." % (regressions, 100. * threshold))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
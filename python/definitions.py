@@ -96,7 +96,8 @@ smoother_names = {
 smoothers = list(smoother_names.values())
 
 sampling_planners = ['rrt', 'est', 'sbl', 'prm',
-                     'theta_star', 'sst', 'kpiece', 'pdst', 'stride']
+                     'theta_star', 'jps', 'hybrid_astar', 'sst', 'kpiece',
+                     'pdst', 'stride']
 anytime_planners = ['rrt_star', 'rrt_sharp', 'informed_rrt_star', 'sorrt_star', 'prm_star', 'fmt', 'bfmt', 'cforest',
                     'bit_star', 'spars', 'spars2']
 controlbased_planners = ['fpkpiece', 'fpest', 'fpsst', 'fprrt', 'fppdst']
@@ -111,6 +112,8 @@ planner_names = {
     'sbl': 'SBL',
     'prm': 'PRM',
     'theta_star': 'Theta*',
+    'jps': 'JPS',
+    'hybrid_astar': 'Hybrid A*',
     'sst': 'SST',
     'fmt': 'FMT',
     'kpiece': 'KPIECE',
@@ -145,6 +148,8 @@ planner_internal_names = {
     'sbl': 'SBL',
     'prm': 'PRM',
     'theta_star': 'Theta*',
+    'jps': 'JPS',
+    'hybrid_astar': 'Hybrid A*',
     'sst': 'SST',
     'fmt': 'FMT',
     'kpiece': 'KPIECE1',
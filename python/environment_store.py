@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""
+Resolves grid maps that were stored once per content hash in sidecar files
+(setting "store_environments") instead of being embedded in every run record.
+"""
+import base64
+import json
+import os
+import struct
+
+
+def load_environment(filename: str):
+    with open(filename, "r") as f:
+        stored = json.load(f)
+    width, height = stored["width"], stored["height"]
+    bits = base64.b64decode(stored["map"])
+    cells = width * height
+    env = {
+        "map": ''.join('1' if bits[i // 8] >> (i % 8) & 1 else '0' for i in range(cells))
+    }
+    if "distances" in stored:
+        halves = base64.b64decode(stored["distances"])
+        env["distances"] = list(struct.unpack('<%ie' % (len(halves) // 2), halves))
+    return env
+
+
+def resolve_environments(data: dict, json_file: str):
+    """
+    Replaces the "map_ref" of every run environment in the results by the map
+    (and distances) stored in the referenced sidecar file, so that the results
+    can be used as if the maps were embedded. Modifies and returns data.
+    """
+    directory = os.path.dirname(os.path.abspath(json_file))
+    cache = {}
+    for run in data.get("runs", []):
+        env = run.get("environment", {})
+        if "map_ref" not in env:
+            continue
+        reference = env.pop("map_ref")
+        key = reference["hash"]
+        if key not in cache:
+            filename = os.path.join(directory, reference["file"])
+            if not os.path.exists(filename):
+                print("Error: could not find stored environment %s." % filename)
+                cache[key] = None
+            else:
+                cache[key] = load_environment(filename)
+        if cache[key] is not None:
+            env.update(cache[key])
+    return data
+
+
+def rebase_environment_references(data: dict, json_file: str, target_file: str):
+    """
+    Rewrites the "map_ref" files of the run environments, which are relative
+    to json_file, to be relative to target_file, e.g. when results are merged
+    into a file in another directory. Modifies and returns data.
+    """
+    directory = os.path.dirname(os.path.abspath(json_file))
+    target_directory = os.path.dirname(os.path.abspath(target_file))
+    for run in data.get("runs", []):
+        reference = run.get("environment", {}).get("map_ref")
+        if reference is None:
+            continue
+        filename = os.path.join(directory, reference["file"])
+        reference["file"] = os.path.relpath(filename, target_directory)
+    return data
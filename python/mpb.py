@@ -13,6 +13,7 @@ from threading import Timer
 from copy import deepcopy
 
 from utils import *
+from environment_store import rebase_environment_references
 from multiprocessing import Pool
 from tqdm.notebook import tqdm
 
@@ -461,6 +462,8 @@ class MPB:
                         print("Benchmark %s has empty results file %s. Skipping."
                               % (str(m), results_filenames[i]), file=sys.stderr)
                         continue
+                    # stored environments are referenced relative to the results file
+                    rebase_environment_references(res, results_filenames[i], target_filename)
                     if i == 0 or target is None:
                         target = deepcopy(res)
                         target["runs"] = []
@@ -8,6 +8,7 @@ import sys
 from bitarray import bitarray
 
 from utils import add_options
+from environment_store import resolve_environments
 
 plot_env_options = [
     click.option('--show_distances', default=False, type=bool),
@@ -147,6 +148,7 @@ def main(json_file: str, run_id: str, draw_start_goal=True, draw_start_goal_thet
     import matplotlib.pyplot as plt
 
     data = json.load(open(json_file, 'r'))
+    resolve_environments(data, json_file)
     if run_id.lower() == "all":
         run_ids = list(range(len(data["runs"])))
     else:
@@ -4,6 +4,8 @@ import click
 import math
 import sys
 
+from environment_store import resolve_environments
+from trajectory_codec import decode_trajectories
 from plot_env import plot_env, plot_env_options
 from plot_trajectory import plot_trajectory, plot_nodes, plot_trajectory_options
 from color import get_color, get_colors, color_options
@@ -73,6 +75,8 @@ def visualize_traj_convergence(json_file: str, run_id: str = 'all',
     file = open(json_file, "r")
     data = json.load(file)
     file.close()
+    resolve_environments(data, json_file)
+    decode_trajectories(data)
     run_ids = parse_run_ids(run_id, len(data["runs"]))
 
     if combine_views:
@@ -111,7 +115,9 @@ def visualize_traj_convergence(json_file: str, run_id: str = 'all',
             colors = get_colors(len(plan["intermediary_solutions"]), **kwargs)
             for si, solution in enumerate(plan["intermediary_solutions"]):
                 label = '%s (%.2f s)' % (convert_planner_name(planner), solution["time"])
-                plot_trajectory(solution["trajectory"], label, settings, color=colors[si], **kwargs)
+                # the interpolated trajectories of intermediary solutions are optional
+                trajectory = solution["trajectory"] if "trajectory" in solution else solution["path"]
+                plot_trajectory(trajectory, label, settings, color=colors[si], **kwargs)
                 if draw_nodes:
                     plot_nodes(solution["path"], label, settings, color=colors[si], **kwargs)
 
@@ -6,6 +6,8 @@ import sys
 
 import definitions
 from definitions import smoother_names
+from environment_store import resolve_environments
+from trajectory_codec import decode_trajectories
 from plot_env import plot_env, plot_env_options
 from plot_trajectory import plot_trajectory, plot_nodes, plot_trajectory_options
 from color import get_color, get_colors, color_options
@@ -93,6 +95,8 @@ def visualize(json_file: str,
     file = open(json_file, "r")
     data = json.load(file)
     file.close()
+    resolve_environments(data, json_file)
+    decode_trajectories(data)
     run_ids = parse_run_ids(run_id, len(data["runs"]))
 
     axes_h, axes_v = 1, 1
@@ -314,6 +318,8 @@ def visualize_grid(json_file: str,
     file = open(json_file, "r")
     data = json.load(file)
     file.close()
+    resolve_environments(data, json_file)
+    decode_trajectories(data)
     run_ids = parse_run_ids(run_id, len(data["runs"]))
 
     planners = []
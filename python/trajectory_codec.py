@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+"""
+Decodes trajectories that were logged with the setting
+"benchmark.trajectory_compression" (simplified, quantised and delta-encoded).
+"""
+import math
+
+
+def is_encoded(trajectory):
+    return isinstance(trajectory, dict) and trajectory.get("encoding") == "dp_delta"
+
+
+def decode_trajectory(trajectory):
+    """
+    Returns the list of (x, y, yaw) states of a logged trajectory, which is
+    passed through unchanged if it is not encoded.
+    """
+    if not is_encoded(trajectory):
+        return trajectory
+    resolution, yaw_resolution = trajectory["resolution"], trajectory["yaw_resolution"]
+    data = trajectory["data"]
+    states = []
+    qx, qy, qyaw = 0, 0, 0
+    for i in range(0, len(data) - 2, 3):
+        qx += data[i]
+        qy += data[i + 1]
+        qyaw += data[i + 2]
+        yaw = qyaw * yaw_resolution
+        states.append([qx * resolution, qy * resolution, math.atan2(math.sin(yaw), math.cos(yaw))])
+    return states
+
+
+def decode_trajectories(data: dict):
+    """
+    Decodes all trajectories of the planners, smoothers and intermediary
+    solutions in the results in place. Modifies and returns data.
+    """
+    for run in data.get("runs", []):
+        for plan in run.get("plans", {}).values():
+            if plan is None:
+                continue
+            entries = [plan]
+            entries += [s for s in (plan.get("smoothing") or {}).values() if s is not None]
+            entries += [s for s in (plan.get("intermediary_solutions") or []) if s is not None]
+            for entry in entries:
+                if "trajectory" in entry:
+                    entry["trajectory"] = decode_trajectory(entry["trajectory"])
+    return data
@@ -0,0 +1,91 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <utility>
+
+// MPB
+#include "base/Environment.h"
+#include "base/SweptFootprint.h"
+
+// Other
+#include <ompl/base/MotionValidator.h>
+#include <ompl/base/SpaceInformation.h>
+
+namespace ob = ompl::base;
+
+class GridMaze;
+
+/**
+ * Motion validator that checks the intermediate states of a motion in
+ * bisection (van der Corput) order, i.e. the middle state first, then the
+ * quarter states, and so on. Collisions along an invalid motion are thereby
+ * found after a few checks instead of after scanning the motion from its
+ * start. All intermediate states of a motion are interpolated into the same
+ * two scratch states, which are allocated per call so that the validator can
+ * be used from several threads, and checking stops at the first collision.
+ *
+ * For the polygon collision model, the motion is checked continuously: it is
+ * divided into segments of at most env.collision.swept_segment_length whose
+ * swept areas are each covered by a single polygon (see SweptFootprint).
+ * Segments whose swept area collides are subdivided down to the state
+ * validity checking resolution before the motion is rejected, so that a few
+ * swept tests replace the dense sampling of the motion and no collision
+ * between samples is missed.
+ *
+ * On grids, motions through open space are accepted right away by a single
+ * conservative test against the occupancy pyramid (see GridMaze::motionFree).
+ */
+class BisectionMotionValidator : public ob::MotionValidator {
+ public:
+  BisectionMotionValidator(const ob::SpaceInformationPtr &si,
+                           const std::shared_ptr<Environment> &env);
+
+  ~BisectionMotionValidator() override = default;
+
+  bool checkMotion(const ob::State *s1, const ob::State *s2) const override;
+  bool checkMotion(const ob::State *s1, const ob::State *s2,
+                   std::pair<ob::State *, double> &lastValid) const override;
+
+  /**
+   * Whether the interpolation of the current steer function fulfills the
+   * requirements of this validator, i.e. whether its state space distance
+   * bounds the arc length of the reference point and its curvature is
+   * bounded (or it is linear).
+   */
+  static bool supportsSteering();
+
+ protected:
+  /**
+   * Checks the element with the given index (1 to n) of the motion, which is
+   * a state for the point robot and a swept segment for the polygon robot.
+   */
+  bool checkElement(const ob::State *s1, const ob::State *s2, unsigned int i,
+                    unsigned int n, double length,
+                    ob::State *const *scratch) const;
+
+  /**
+   * Checks whether the area swept by the robot footprint between the
+   * interpolated states at t1 and t2 is free, refining the segment if its
+   * conservative swept area collides.
+   */
+  bool checkSweptSegment(const ob::State *s1, const ob::State *s2, double t1,
+                         double t2, double length,
+                         ob::State *const *scratch) const;
+
+  /**
+   * Checks whether the conservative swept area of the segment between the
+   * interpolated states at t1 and t2 is free.
+   */
+  bool sweptFree(const ob::State *s1, const ob::State *s2, double t1,
+                 double t2, double length, ob::State *const *scratch) const;
+
+  bool check(const ob::State *s1, const ob::State *s2,
+             std::pair<ob::State *, double> *lastValid) const;
+
+  std::shared_ptr<Environment> env_;
+  // only set if the environment is a grid
+  GridMaze *grid_{nullptr};
+  // only set for the polygon collision model
+  std::unique_ptr<SweptFootprint> footprint_;
+};
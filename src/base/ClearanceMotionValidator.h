@@ -0,0 +1,58 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <utility>
+
+// MPB
+#include "base/Environment.h"
+
+// Other
+#include <ompl/base/MotionValidator.h>
+#include <ompl/base/SpaceInformation.h>
+
+namespace ob = ompl::base;
+
+/**
+ * Motion validator that adapts its step size to the clearance of the checked
+ * states. If the reference point of a sampled state has clearance d for the
+ * robot's circumscribed radius (see Environment::clearance), the next d of
+ * arc length along the motion are free, so that the next state to check lies
+ * that far ahead. The step never falls below the state validity checking
+ * resolution, i.e. no more states are checked than by OMPL's
+ * DiscreteMotionValidator.
+ *
+ * Requires steer functions whose interpolation is parameterized by arc
+ * length, where the exact distance of the state space between two states is
+ * an upper bound on the length of the curve traced by the reference point.
+ */
+class ClearanceMotionValidator : public ob::MotionValidator {
+ public:
+  ClearanceMotionValidator(const ob::SpaceInformationPtr &si,
+                           const std::shared_ptr<Environment> &env);
+
+  ~ClearanceMotionValidator() override = default;
+
+  bool checkMotion(const ob::State *s1, const ob::State *s2) const override;
+  bool checkMotion(const ob::State *s1, const ob::State *s2,
+                   std::pair<ob::State *, double> &lastValid) const override;
+
+  /**
+   * Circumscribed radius of the robot around its reference point according
+   * to the collision model.
+   */
+  double robotRadius() const { return radius_; }
+
+  /**
+   * Whether the interpolation of the current steer function fulfills the
+   * requirements of this validator.
+   */
+  static bool supportsSteering();
+
+ protected:
+  bool check(const ob::State *s1, const ob::State *s2,
+             std::pair<ob::State *, double> *lastValid) const;
+
+  std::shared_ptr<Environment> env_;
+  double radius_{0};
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "base/Primitives.h"
+
+/**
+ * Convex polygon in structure-of-arrays layout. Edge i connects vertex i and
+ * vertex i+1 (modulo size), (nx[i], ny[i]) is its outward normal.
+ */
+struct ConvexPolygonView {
+  const double *x{nullptr}, *y{nullptr};
+  const double *nx{nullptr}, *ny{nullptr};
+  std::size_t size{0};
+  double min_x{0}, min_y{0}, max_x{0}, max_y{0};
+};
+
+/**
+ * Separating axis tests for convex polygons. Two convex polygons are disjoint
+ * if and only if one of them lies entirely on the outer side of an edge of
+ * the other, so only the edge normals of both polygons are tested, and only
+ * in their outward direction. Touching polygons intersect.
+ */
+namespace sat {
+/**
+ * Whether b lies entirely on the outer side of an edge of a.
+ */
+inline bool separatedByEdgeOf(const ConvexPolygonView &a,
+                              const ConvexPolygonView &b) {
+  for (std::size_t i = 0; i < a.size; ++i) {
+    const double ax = a.nx[i], ay = a.ny[i];
+    const double edge = ax * a.x[i] + ay * a.y[i];
+    double lowest = std::numeric_limits<double>::infinity();
+    for (std::size_t j = 0; j < b.size; ++j)
+      lowest = std::min(lowest, ax * b.x[j] + ay * b.y[j]);
+    if (lowest > edge) return true;
+  }
+  return false;
+}
+
+inline bool intersects(const ConvexPolygonView &a, const ConvexPolygonView &b) {
+  if (a.max_x < b.min_x || a.min_x > b.max_x || a.max_y < b.min_y ||
+      a.min_y > b.max_y)
+    return false;
+  return !separatedByEdgeOf(a, b) && !separatedByEdgeOf(b, a);
+}
+
+/**
+ * Intersection test with the axis-aligned box [x1, x2] x [y1, y2]. The normals
+ * of the box are the coordinate axes, which the bounding box test covers.
+ */
+inline bool intersectsBox(const ConvexPolygonView &a, double x1, double y1,
+                          double x2, double y2) {
+  if (a.max_x < x1 || a.min_x > x2 || a.max_y < y1 || a.min_y > y2)
+    return false;
+  const double cx = .5 * (x1 + x2), cy = .5 * (y1 + y2);
+  const double hx = .5 * (x2 - x1), hy = .5 * (y2 - y1);
+  for (std::size_t i = 0; i < a.size; ++i) {
+    const double ax = a.nx[i], ay = a.ny[i];
+    // lowest projection of the box onto the normal
+    const double lowest =
+        ax * cx + ay * cy - hx * std::abs(ax) - hy * std::abs(ay);
+    if (lowest > ax * a.x[i] + ay * a.y[i]) return false;
+  }
+  return true;
+}
+}  // namespace sat
+
+/**
+ * Convex footprint with a fixed maximum number of vertices and precomputed
+ * edge normals, so that it can be placed at a state and collision-checked
+ * without heap allocations, e.g. in a buffer on the caller's stack.
+ *
+ * Non-convex polygons are represented by their convex hull, which is a
+ * conservative approximation for collision checking.
+ */
+class ConvexFootprint {
+ public:
+  static constexpr std::size_t Capacity = 32;
+
+  ConvexFootprint() = default;
+
+  /**
+   * Sets the vertices to the given polygon, or to its convex hull if it is
+   * not convex.
+   * @return False if the polygon has fewer than three or more than Capacity
+   * vertices, in which case the footprint is left empty.
+   */
+  bool assign(const Polygon &polygon);
+
+  /**
+   * Places this footprint, given relative to the reference point of the
+   * robot, at the pose (x, y, yaw) and writes the result to out.
+   */
+  void transform(double x, double y, double yaw, ConvexFootprint &out) const;
+
+  void transform(const ob::State *state, ConvexFootprint &out) const {
+    const auto *s = state->as<State>();
+    transform(s->getX(), s->getY(), s->getYaw(), out);
+  }
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  ConvexPolygonView view() const {
+    return {x_, y_, nx_, ny_, size_, min_x_, min_y_, max_x_, max_y_};
+  }
+
+  /**
+   * Copy of the vertices for code paths that require a Polygon.
+   */
+  Polygon polygon() const;
+
+ private:
+  void updateBounds();
+
+  std::size_t size_{0};
+  double x_[Capacity], y_[Capacity];
+  double nx_[Capacity], ny_[Capacity];
+  double min_x_{0}, min_y_{0}, max_x_{0}, max_y_{0};
+};
+
+/**
+ * Convex footprint of the polygon passed last, which is only rebuilt when the
+ * vertices change. Callers keep an instance per thread (thread_local). Meant
+ * for the fixed robot shape; polygons that change on every call (e.g. placed
+ * footprints or swept hulls) are assigned to a ConvexFootprint directly.
+ */
+class CachedConvexFootprint {
+ public:
+  /**
+   * @return The footprint of the polygon, or nullptr if the polygon does not
+   * fit into a ConvexFootprint (see ConvexFootprint::assign).
+   */
+  const ConvexFootprint *get(const Polygon &polygon);
+
+ private:
+  std::vector<Point> points_;
+  ConvexFootprint footprint_;
+  bool fits_{false};
+};
+
+/**
+ * Convex polygon with an arbitrary number of vertices and precomputed edge
+ * normals, used for static obstacles whose normals are computed once.
+ */
+class ConvexPolygon {
+ public:
+  /**
+   * Uses the convex hull of the polygon if it is not convex.
+   */
+  explicit ConvexPolygon(const Polygon &polygon);
+
+  ConvexPolygonView view() const {
+    return {x_.data(), y_.data(), nx_.data(), ny_.data(), x_.size(),
+            min_x_,    min_y_,    max_x_,     max_y_};
+  }
+
+ private:
+  std::vector<double> x_, y_, nx_, ny_;
+  double min_x_{0}, min_y_{0}, max_x_{0}, max_y_{0};
+};
@@ -2,7 +2,12 @@
 
 #include <ompl/base/ScopedState.h>
 
+#include <atomic>
+#include <cstdint>
+
+#include "base/ConvexFootprint.h"
 #include "base/Primitives.h"
+#include "utils/ContentHash.hpp"
 #include "utils/Stopwatch.hpp"
 
 class Environment {
@@ -18,6 +23,9 @@ class Environment {
 
   virtual bool collides(double x, double y) { return true; }
   virtual bool collides(const Polygon &polygon) { return true; }
+  virtual bool collides(const ConvexFootprint &footprint) {
+    return collides(footprint.polygon());
+  }
   bool collides(const Point &p) { return collides(p.x, p.y); }
   bool collides(const ompl::geometric::PathGeometric &trajectory);
   bool collides(const ob::State *state) {
@@ -30,6 +38,13 @@ class Environment {
    */
   bool checkValidity(const ob::State *state);
 
+  /**
+   * Whether the robot shape placed at the given state collides, using a
+   * cached convex footprint of the robot shape that is transformed into a
+   * stack buffer.
+   */
+  bool collidesFootprint(const ob::State *state);
+
   inline const ob::RealVectorBounds &bounds() const { return _bounds; }
   inline double width() const { return _bounds.high.at(0) - _bounds.low.at(0); }
   inline double height() const {
@@ -48,6 +63,21 @@ class Environment {
    */
   virtual double distance(double x, double y) { return -1; }
 
+  /**
+   * Lower bound on the distance the xy-coordinate can be moved in any
+   * direction while collides(x, y) remains false, or, for a positive radius,
+   * while no polygon within that radius of the xy-coordinate collides.
+   *
+   * @param x X-coordinate of the point to check.
+   * @param y Y-Coordinate of the point to check.
+   * @param radius Circumscribed radius of the robot polygon around its
+   * reference point, zero for the point robot.
+   * @return The clearance, or a non-positive value if it is unknown.
+   */
+  virtual double clearance(double x, double y, double radius = 0) {
+    return 0;
+  }
+
   /**
    * Compute distance of a state to the closest obstacle if possible.
    *
@@ -124,6 +154,13 @@ class Environment {
    */
   virtual double unit() const { return 1; }
 
+  /**
+   * Hash of the bounds and obstacles, which identifies the environment in
+   * caches of derived data. It is computed once and recomputed only after
+   * the obstacles have changed.
+   */
+  std::uint64_t contentHash() const;
+
   void resetCollisionTimer() { _collision_timer.reset(); }
   double elapsedCollisionTime() const { return _collision_timer.elapsed(); }
 
@@ -137,4 +174,18 @@ class Environment {
   ob::RealVectorBounds _bounds{2};
 
   Stopwatch _collision_timer;
+
+  /**
+   * Adds the bounds and obstacles to the content hash.
+   */
+  virtual void hashContent(ContentHash &hash) const;
+
+  /**
+   * Has to be called whenever the obstacles change.
+   */
+  void invalidateContentHash() { _content_hash = 0; }
+
+ private:
+  // zero if the hash has not been computed
+  mutable std::atomic<std::uint64_t> _content_hash{0};
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * Content-addressed store for grid maps that are logged with the results.
+ * Instead of embedding the occupancy (and distances) of a grid in every run
+ * record, each distinct map is written once to a sidecar file in the
+ * directory "environments" next to the log file, and run records reference
+ * it by its hash.
+ *
+ * The sidecar file is a JSON object with the width and height of the grid,
+ * the base64-encoded occupancy packed into bits (row-major, least
+ * significant bit first) and, if present, the base64-encoded distances as
+ * little-endian IEEE 754 half-precision floats. python/environment_store.py
+ * resolves the references.
+ *
+ * Enabled by global::settings.store_environments.
+ */
+class EnvironmentStore {
+ public:
+  EnvironmentStore() = delete;
+
+  /**
+   * Stores the grid given by its occupancy string (one '0' or '1' per cell)
+   * and optional distances unless it has been stored already. Returns the
+   * reference ("hash" and "file" relative to the log file) to be logged in
+   * place of the map, or null if the map could not be written.
+   */
+  static nlohmann::json store(const std::string &map, unsigned int width,
+                              unsigned int height,
+                              const std::vector<double> &distances = {});
+
+  /**
+   * Converts a float to the bit pattern of the nearest IEEE 754
+   * half-precision float.
+   */
+  static std::uint16_t toHalf(float value);
+};
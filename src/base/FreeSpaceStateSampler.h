@@ -0,0 +1,80 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <vector>
+
+// Other
+#include <ompl/base/StateSampler.h>
+#include <ompl/base/samplers/deterministic/HaltonSequence.h>
+
+namespace ob = ompl::base;
+
+class GridMaze;
+
+/**
+ * State sampler that only draws positions from the free cells of a grid
+ * environment. A free cell is selected (uniformly or weighted by the inverse
+ * of its clearance to favor narrow passages), the position is jittered
+ * uniformly within the cell, and the heading is sampled uniformly. All other
+ * components of the state (e.g. curvature) are sampled by the default
+ * sampler of the state space.
+ *
+ * Supports state spaces derived from SE2StateSpace, and the compound
+ * curvature state spaces (R^2, SO(2), R^1) of the CC and HC steer functions.
+ */
+class FreeSpaceStateSampler : public ob::StateSampler {
+ public:
+  /**
+   * Free cells of a grid environment together with their cumulative sampling
+   * weights.
+   */
+  struct FreeCellIndex {
+    std::vector<unsigned int> cells;
+    /**
+     * Prefix sums of the weights of the free cells, empty if all cells are
+     * equally likely.
+     */
+    std::vector<double> cumulative_weights;
+    unsigned int voxels_x{0};
+    double width{0};
+    double height{0};
+
+    /**
+     * Collects the free cells of the grid. If clearance_weighted is true,
+     * every cell is weighted by the inverse of its distance to the nearest
+     * obstacle (at least one cell), which requires the distance field.
+     */
+    static std::shared_ptr<FreeCellIndex> build(GridMaze &grid,
+                                                bool clearance_weighted);
+  };
+
+  FreeSpaceStateSampler(const ob::StateSpace *space,
+                        std::shared_ptr<const FreeCellIndex> index,
+                        bool low_discrepancy = false);
+
+  ~FreeSpaceStateSampler() override = default;
+
+  void sampleUniform(ob::State *state) override;
+  void sampleUniformNear(ob::State *state, const ob::State *near,
+                         double distance) override;
+  void sampleGaussian(ob::State *state, const ob::State *mean,
+                      double stdDev) override;
+
+  /**
+   * Whether the sampler can be used with the given state space.
+   */
+  static bool supports(const ob::StateSpace *space);
+
+ protected:
+  void setPose(ob::State *state, double x, double y, double yaw) const;
+
+  std::shared_ptr<const FreeCellIndex> index_;
+  ob::StateSamplerPtr default_;
+  /**
+   * Deterministic sequence for cell selection, jitter and heading if the
+   * low-discrepancy mode is used.
+   */
+  std::shared_ptr<ob::HaltonSequence> halton_;
+  bool se2_{true};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/Primitives.h"
+
+class Environment;
+
+/**
+ * Cost-to-go table of a point robot towards a goal, i.e. the length of the
+ * shortest 8-connected path around the obstacles from every cell of a grid
+ * over the environment to the goal cell, computed by Dijkstra's algorithm.
+ * A cell is only occupied if no part of it is free, so that narrow passages
+ * stay open and the table remains a lower bound. Grid mazes are rasterized
+ * from their cells without the footprint of GridMaze::occupied(x, y).
+ *
+ * Tables are cached by the content hash of the environment and the goal, so
+ * that repeated runs on the same map and goal (e.g. of different planners in
+ * a benchmark) rasterize the map and compute the table only once.
+ */
+class HeuristicTable {
+ public:
+  /**
+   * Returns the table for the environment and goal at the resolution given
+   * by env.heuristic.resolution, computing it if it is not cached yet.
+   */
+  static std::shared_ptr<const HeuristicTable> get(Environment &environment,
+                                                   const Point &goal);
+
+  /**
+   * Estimate of the length of the shortest collision-free path from (x, y)
+   * to the goal. The grid path length is scaled down by the largest ratio
+   * between 8-connected and Euclidean distances and reduced by one cell
+   * diagonal for the offsets within the start and goal cells, such that the
+   * estimate is a lower bound on maps whose obstacles align with the cells.
+   * Never less than the Euclidean distance to the goal, which is also
+   * returned for cells that are occupied or cannot reach the goal.
+   */
+  double costToGo(double x, double y) const;
+
+  const Point &goal() const { return goal_; }
+  double resolution() const { return resolution_; }
+  unsigned int cellsX() const { return cells_x_; }
+  unsigned int cellsY() const { return cells_y_; }
+
+  /**
+   * Ratio of cells whose grid path length to the goal is known.
+   */
+  double reachableRatio() const;
+
+ private:
+  HeuristicTable(const Point &goal, double min_x, double min_y,
+                 double resolution, unsigned int cells_x, unsigned int cells_y,
+                 const std::vector<bool> &occupied);
+
+  std::vector<float> costs_;
+  Point goal_;
+  double min_x_, min_y_;
+  double resolution_;
+  unsigned int cells_x_, cells_y_;
+};
@@ -20,6 +20,17 @@ struct PathStatistics : public Group {
                                   "collision_time", this};
   Property<double> steering_time{std::numeric_limits<double>::quiet_NaN(),
                                  "steering_time", this};
+  Property<double> interpolation_cache_hit_rate{
+      std::numeric_limits<double>::quiet_NaN(), "interpolation_cache_hit_rate",
+      this};
+  Property<bool> roadmap_reused{false, "roadmap_reused", this};
+  Property<double> roadmap_construction_time{
+      std::numeric_limits<double>::quiet_NaN(), "roadmap_construction_time",
+      this};
+  Property<double> roadmap_load_time{std::numeric_limits<double>::quiet_NaN(),
+                                     "roadmap_load_time", this};
+  Property<double> roadmap_query_time{std::numeric_limits<double>::quiet_NaN(),
+                                      "roadmap_query_time", this};
   Property<bool> path_found{false, "path_found", this};
   Property<bool> path_collides{true, "path_collides", this};
   Property<bool> exact_goal_path{true, "exact_goal_path", this};
@@ -2,9 +2,12 @@
 
 #include <ompl/geometric/planners/rrt/RRTstar.h>
 
+#include <type_traits>
+
 #include "PlannerSettings.h"
 #include "planners/OMPLControlPlanner.hpp"
 #include "planners/OMPLPlanner.hpp"
+#include "utils/SteerAwareNearestNeighbors.hpp"
 
 namespace ob = ompl::base;
 namespace og = ompl::geometric;
@@ -20,6 +23,9 @@ class PlannerConfigurator {
   static void configure(OMPLPlanner<OMPL_PLANNER> &planner) {
     configure(*planner.omplPlanner(),
               global::settings.ompl.geometric_planner_settings.value());
+    if (global::settings.ompl.nearest_neighbors.value() == "steer_aware")
+      configureNearestNeighbors(
+          *static_cast<OMPL_PLANNER *>(planner.omplPlanner()));
   }
 
   template <typename OMPL_PLANNER>
@@ -29,6 +35,34 @@ class PlannerConfigurator {
   }
 
  private:
+  template <typename OMPL_PLANNER>
+  static void configureNearestNeighbors(OMPL_PLANNER &planner) {
+    // the lower bounds only hold for distances of the state space, whereas
+    // e.g. FMT* measures distances by the motion cost of the objective
+    if (global::settings.ompl.optimization_objective.value() !=
+        "min_pathlength") {
+      OMPL_WARN(
+          "The steer-aware nearest neighbors require the path length "
+          "objective. Using the default of %s instead.",
+          planner.getName().c_str());
+      return;
+    }
+    if constexpr (std::is_base_of_v<og::RRTstar, OMPL_PLANNER> ||
+                  std::is_base_of_v<og::FMT, OMPL_PLANNER> ||
+                  std::is_base_of_v<og::BITstar, OMPL_PLANNER>) {
+      planner.template setNearestNeighbors<SteerAwareNearestNeighbors>();
+    } else if constexpr (std::is_base_of_v<og::PRM, OMPL_PLANNER>) {
+      // PRM's vertices are boost graph descriptors that do not know their
+      // states
+      steer_aware_nn::usePRM(planner);
+    } else {
+      OMPL_WARN(
+          "Planner %s does not support the steer-aware nearest neighbors. "
+          "Using its default instead.",
+          planner.getName().c_str());
+    }
+  }
+
   static void configure(ob::Planner &planner, const nlohmann::json &settings) {
     const auto name = planner.getName();
     auto params = planner.params();
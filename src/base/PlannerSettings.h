@@ -3,6 +3,7 @@
 #include <chomp/Chomp.h>
 #include <ompl/control/ODESolver.h>
 
+#include <atomic>
 #include <memory>
 #include <params.hpp>
 
@@ -10,6 +11,8 @@
 #include "fp_models/ForwardPropagation.h"
 #include "steer_functions/Steering.h"
 
+class SteerDistanceTable;
+
 using namespace params;
 
 namespace sbpl {
@@ -221,8 +224,78 @@ struct GlobalSettings : public Group {
       Property<std::string> robot_shape_source{"polygon_mazes/car.svg",
                                                "robot_shape_source", this};
 
+      /**
+       * For linear steering and the point collision model, check segments on
+       * grid environments by traversing all grid cells they touch instead of
+       * collision-checking interpolated states. Disabled by default so that
+       * results remain comparable to those of earlier benchmarks.
+       */
+      Property<bool> exact_line_of_sight{false, "exact_line_of_sight", this};
+
+      /**
+       * Validate motions with step sizes that adapt to the clearance of the
+       * checked states (see ClearanceMotionValidator). Requires environments
+       * that provide a clearance, e.g. grid environments with their distance
+       * field, otherwise the regular resolution is used.
+       */
+      Property<bool> adaptive_motion_validation{
+          false, "adaptive_motion_validation", this};
+
+      /**
+       * Validate motions by checking their intermediate states in bisection
+       * order until the first collision (see BisectionMotionValidator). For
+       * the polygon collision model, motions are checked continuously by the
+       * swept areas of segments of length swept_segment_length.
+       */
+      Property<bool> bisection_motion_validation{
+          false, "bisection_motion_validation", this};
+
+      /**
+       * Length (in units of the state space distance) of the motion segments
+       * whose swept areas are checked by the BisectionMotionValidator for
+       * the polygon collision model. Longer segments need fewer checks in
+       * free space but are subdivided more often near obstacles.
+       */
+      Property<double> swept_segment_length{1., "swept_segment_length", this};
+
       void initializeCollisionModel();
     } collision{"collision", this};
+
+    /**
+     * Settings of the cost-to-go table of the point robot around the
+     * obstacles (see HeuristicTable), which replaces the Euclidean distance
+     * to the goal as heuristic.
+     */
+    struct HeuristicSettings : public Group {
+      using Group::Group;
+
+      /**
+       * Cell size of the table.
+       */
+      Property<double> resolution{1., "resolution", this};
+
+      /**
+       * Number of tables (per map and goal) that are kept in memory.
+       */
+      Property<unsigned int> cache_size{8, "cache_size", this};
+
+      /**
+       * Use the table as heuristic of Theta*.
+       */
+      Property<bool> theta_star{false, "theta_star", this};
+
+      /**
+       * Add the table as additional heuristic to SBPL's MHA*.
+       */
+      Property<bool> sbpl_mha{false, "sbpl_mha", this};
+
+      /**
+       * Sample only states whose Euclidean distance from the start plus
+       * cost-to-go can improve the current solution when informed sampling
+       * is used with the path length objective.
+       */
+      Property<bool> informed_sampling{false, "informed_sampling", this};
+    } heuristic{"heuristic", this};
   } env{"env", this};
 
   /**
@@ -230,6 +303,13 @@ struct GlobalSettings : public Group {
    */
   Property<bool> log_env_distances{false, "log_env_distances", this};
 
+  /**
+   * Whether to store the maps of grid mazes (and their distances if
+   * log_env_distances is set) once per distinct map in a sidecar file next
+   * to the log file, instead of embedding them in every run record.
+   */
+  Property<bool> store_environments{false, "store_environments", this};
+
   Property<bool> auto_choose_distance_computation_method{
       true, "auto_choose_distance_computation_method", this};
   Property<distance_computation::Method> distance_computation_method{
@@ -302,6 +382,14 @@ struct GlobalSettings : public Group {
         this};
 
     Property<bool> control_planners_on{false, "control_planners_on", this};
+
+    /**
+     * Reuse configured planners across runs and scenarios instead of
+     * constructing a new planner for every run (see PlannerPool). Planners
+     * are reconstructed when the environment, the state space or the
+     * settings change.
+     */
+    Property<bool> reuse_planners{false, "reuse_planners", this};
     Property<std::vector<ForwardPropagation::ForwardPropagationType>>
         forward_propagations{
             {ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_CAR},
@@ -314,6 +402,63 @@ struct GlobalSettings : public Group {
     Property<std::vector<double>> anytime_intervals{
         {1., 3., 5., 10., 15., 20., 25., 30.}, "anytime_intervals", this};
 
+    /**
+     * Settings for the evaluation of the intermediary solutions reported by
+     * anytime planners after each run.
+     */
+    struct IntermediarySolutionSettings : public Group {
+      using Group::Group;
+      /**
+       * Minimum relative cost change with respect to the previously kept
+       * solution for a solution to be evaluated, zero keeps all solutions.
+       */
+      Property<double> min_cost_improvement{0, "min_cost_improvement", this};
+      /**
+       * Length (in seconds) of the time buckets of which only the last
+       * solution is kept, zero disables the bucketing.
+       */
+      Property<double> time_bucket{0, "time_bucket", this};
+      /**
+       * Maximum number of solutions, selected evenly from the ones that
+       * remain after filtering by cost and time. Zero for no limit.
+       */
+      Property<unsigned int> max_count{0, "max_count", this};
+      /**
+       * Store the interpolated trajectory of each solution in addition to
+       * its path.
+       */
+      Property<bool> store_trajectory{false, "store_trajectory", this};
+    } intermediary_solutions{"intermediary_solutions", this};
+
+    /**
+     * Lossy compression of the interpolated trajectories in the log (see
+     * TrajectoryCompression). Trajectories are simplified by Douglas-Peucker
+     * within the given tolerances, quantised and delta-encoded. The achieved
+     * errors are logged along with each trajectory.
+     */
+    struct TrajectoryCompressionSettings : public Group {
+      using Group::Group;
+      Property<bool> enabled{false, "enabled", this};
+      /**
+       * Maximum distance (in map units) of the original states from the
+       * simplified trajectory.
+       */
+      Property<double> position_tolerance{0.01, "position_tolerance", this};
+      /**
+       * Maximum yaw deviation (in radians) of the original states from the
+       * simplified trajectory.
+       */
+      Property<double> yaw_tolerance{0.01, "yaw_tolerance", this};
+      /**
+       * Quantisation step of the x and y coordinates.
+       */
+      Property<double> resolution{0.001, "resolution", this};
+      /**
+       * Quantisation step of the yaw angles.
+       */
+      Property<double> yaw_resolution{0.001, "yaw_resolution", this};
+    } trajectory_compression{"trajectory_compression", this};
+
     struct MovingAiSettings : public Group {
       using Group::Group;
 
@@ -339,6 +484,15 @@ struct GlobalSettings : public Group {
        * boundaries.
        */
       Property<bool> create_border{true, "create_border", this};
+
+      /**
+       * Group the selected scenarios by their map and set up the grid, its
+       * distance field, the collision model and the state spaces only once
+       * per map. Only start and goal are updated between the scenarios of
+       * one map, and the log is saved once per map instead of after every
+       * scenario.
+       */
+      Property<bool> batch{false, "batch", this};
     } moving_ai{"moving_ai", this};
 
     /**
@@ -359,6 +513,8 @@ struct GlobalSettings : public Group {
     struct PlanningSettings : public Group {
       using Group::Group;
       Property<bool> theta_star{true, "theta_star", this};
+      Property<bool> jps{false, "jps", this};
+      Property<bool> hybrid_astar{false, "hybrid_astar", this};
       Property<bool> rrt{true, "rrt", this};
       Property<bool> rrt_star{true, "rrt_star", this};
       Property<bool> bit_star{true, "bit_star", this};
@@ -413,6 +569,11 @@ struct GlobalSettings : public Group {
     // planners
     Stopwatch steering_timer;
 
+    // number of interpolations that reused (hits) or computed (misses) a
+    // cached steer function path, see steer.interpolation_cache
+    std::atomic<std::size_t> interpolation_cache_hits{0};
+    std::atomic<std::size_t> interpolation_cache_misses{0};
+
     Property<double> state_equality_tolerance{1e-4, "state_equality_tolerance",
                                               this};
     Property<double> cost_threshold{100, "cost_threshold", this};
@@ -422,10 +583,25 @@ struct GlobalSettings : public Group {
     /**
      * The sampler used by OMPL.
      *
-     * Currently supported: "iid", "halton"
+     * Currently supported: "iid", "halton", and for grid environments
+     * "free_cells" (uniform over free cells), "free_cells_halton"
+     * (low-discrepancy over free cells), "free_cells_clearance" (free cells
+     * weighted by inverse clearance to favor narrow passages).
      */
     Property<std::string> sampler{"iid", "sampler", this};
 
+    /**
+     * The nearest-neighbor structure used by RRT* (and its derivatives),
+     * PRM / PRM*, BIT* and FMT*.
+     *
+     * Currently supported: "default" (OMPL's choice), "steer_aware"
+     * (SteerAwareNearestNeighbors, a k-d tree over the positions that only
+     * computes steer distances for candidates whose lower bound qualifies,
+     * only used with the "min_pathlength" objective).
+     */
+    Property<std::string> nearest_neighbors{"default", "nearest_neighbors",
+                                            this};
+
     /**
      * The optimization objective used by OMPL.
      *
@@ -435,6 +611,30 @@ struct GlobalSettings : public Group {
     Property<std::string> optimization_objective{
         "min_pathlength", "optimization_objective", this};
 
+    /**
+     * Settings for reusing the roadmaps of the multi-query planners PRM,
+     * PRM*, SPARS and SPARS2 between runs on the same map, steer function,
+     * collision model and planner parameters (see RoadmapCache). Later runs
+     * only connect their start and goal to the stored roadmap.
+     */
+    struct RoadmapCacheSettings : public Group {
+      using Group::Group;
+      Property<bool> enabled{false, "enabled", this};
+      /**
+       * Number of roadmaps that are kept in memory.
+       */
+      Property<unsigned int> cache_size{4, "cache_size", this};
+      /**
+       * Store the roadmaps of PRM and PRM* in binary files, from which they
+       * are reloaded when they are no longer kept in memory.
+       */
+      Property<bool> persist{true, "persist", this};
+      /**
+       * Directory where roadmap files are stored.
+       */
+      Property<std::string> cache_dir{"roadmaps", "cache_dir", this};
+    } roadmap_cache{"roadmap_cache", this};
+
     /**
      * Retrieve available parameters and defaults for geometric planners.
      */
@@ -485,10 +685,75 @@ struct GlobalSettings : public Group {
      */
     void initializeSteering() const;
 
+    /**
+     * Loads or generates the distance table for the selected steer function
+     * if enabled (see DistanceTableSettings), otherwise returns nullptr.
+     */
+    std::shared_ptr<const SteerDistanceTable> loadDistanceTable() const;
+
     Property<Steering::SteeringType> steering_type{
         Steering::STEER_TYPE_REEDS_SHEPP, "steering_type", this};
     Property<double> car_turning_radius{4, "car_turning_radius", this};
 
+    /**
+     * Settings for the precomputed Reeds-Shepp and Dubins distance tables
+     * (see SteerDistanceTable). The tables are only used to rank the
+     * candidates of the steer-aware nearest neighbors (see
+     * ompl.nearest_neighbors), motion costs, path metrics and motion
+     * validation use the exact steer function.
+     */
+    struct DistanceTableSettings : public Group {
+      using Group::Group;
+      /**
+       * Whether to look up Reeds-Shepp and Dubins distances for nearest
+       * neighbor queries instead of solving the steering problem.
+       */
+      Property<bool> enabled{false, "enabled", this};
+      /**
+       * Half width of the table in x and y as multiples of the turning
+       * radius. Farther poses use the exact distance.
+       */
+      Property<double> extent{20, "extent", this};
+      /**
+       * Number of samples along x and y.
+       */
+      Property<unsigned int> cells_xy{161, "cells_xy", this};
+      /**
+       * Number of samples along the heading.
+       */
+      Property<unsigned int> cells_theta{72, "cells_theta", this};
+      /**
+       * Largest difference (in turning radii) between the values at the
+       * corners of a table cell for which interpolation is used. Cells with a
+       * larger spread, e.g. at discontinuities of the Dubins distance, use
+       * the exact distance.
+       */
+      Property<double> max_cell_spread{.5, "max_cell_spread", this};
+      /**
+       * Directory where generated tables are cached.
+       */
+      Property<std::string> cache_dir{"steer_tables", "cache_dir", this};
+    } distance_table{"distance_table", this};
+
+    /**
+     * Settings for caching Reeds-Shepp and Dubins paths in the state space.
+     * Interpolating between the same pair of states again (e.g. in the motion
+     * validator, or when a solution is interpolated for evaluation and
+     * logging) then only evaluates the cached path instead of solving the
+     * steering problem.
+     */
+    struct InterpolationCacheSettings : public Group {
+      using Group::Group;
+      /**
+       * Whether to cache the most recently computed steer function paths.
+       */
+      Property<bool> enabled{false, "enabled", this};
+      /**
+       * Number of paths kept per state space.
+       */
+      Property<unsigned int> size{8, "size", this};
+    } interpolation_cache{"interpolation_cache", this};
+
     /**
      * Distance between states sampled using the steer function for collision
      * detection, rendering and evaluation.
@@ -560,6 +825,15 @@ struct GlobalSettings : public Group {
      */
     Property<double> dt{0.1, "dt", this};
 
+    /**
+     * Number of controls that are sampled and propagated together whenever a
+     * control-based planner extends towards a state, the one that gets
+     * closest is kept. Used by planners that rely on directed control
+     * sampling (FP RRT, FP EST), 1 keeps OMPL's default sampler.
+     */
+    Property<unsigned int> batch_control_samples{1, "batch_control_samples",
+                                                 this};
+
   } forwardpropagation{"forwardpropagation", this};
 
   struct SbplSettings : public Group {
@@ -684,8 +958,108 @@ struct GlobalSettings : public Group {
      * This setting is relevant for Theta* and Smooth Theta*.
      */
     Property<int> number_edges{10, "number_edges", this};
+
+    /**
+     * Use Lazy Theta*, which checks the line of sight between a node and its
+     * parent only once the node is expanded instead of for every successor
+     * that is generated.
+     */
+    Property<bool> lazy{false, "lazy", this};
   } thetaStar{"theta_star", this};
 
+  /**
+   * Settings of the Jump Point Search planner.
+   */
+  struct JumpPointSearchSettings : public Group {
+    using Group::Group;
+
+    /**
+     * Precompute the jump distances of every grid vertex in the 8 directions
+     * (JPS+), instead of scanning the grid during each search.
+     */
+    Property<bool> jump_table{true, "jump_table", this};
+
+    /**
+     * Remove the vertices of the grid path that can be skipped by a straight
+     * line of sight.
+     */
+    Property<bool> string_pulling{true, "string_pulling", this};
+
+    /**
+     * Check the segments of the string-pulled path with the steer function
+     * and restore grid vertices where they collide.
+     */
+    Property<bool> steer_postprocessing{true, "steer_postprocessing", this};
+
+    /**
+     * Number of rasterized maps (with their jump tables) kept in memory.
+     */
+    Property<unsigned int> cache_size{4, "cache_size", this};
+  } jps{"jps", this};
+
+  /**
+   * Settings of the Hybrid A* planner.
+   */
+  struct HybridAStarSettings : public Group {
+    using Group::Group;
+
+    /**
+     * Side length of the cells of the closed set as multiple of the unit of
+     * the environment.
+     */
+    Property<double> resolution{1, "resolution", this};
+
+    /**
+     * Number of heading bins of the closed set.
+     */
+    Property<unsigned int> theta_bins{72, "theta_bins", this};
+
+    /**
+     * Arc length of the motion primitives as multiple of the resolution.
+     */
+    Property<double> step_size{1.5, "step_size", this};
+
+    /**
+     * Number of curvatures of the motion primitives on each side of driving
+     * straight, evenly spaced up to the maximum curvature of the steer
+     * function.
+     */
+    Property<unsigned int> curvature_steps{1, "curvature_steps", this};
+
+    /**
+     * Cost factor of driving backwards, if the steer function allows it.
+     */
+    Property<double> reverse_penalty{2, "reverse_penalty", this};
+
+    /**
+     * Cost factor of turning primitives.
+     */
+    Property<double> steering_penalty{1.05, "steering_penalty", this};
+
+    /**
+     * Additional cost of switching the driving direction, as multiple of the
+     * arc length of a primitive.
+     */
+    Property<double> direction_switch_penalty{4, "direction_switch_penalty",
+                                              this};
+
+    /**
+     * An analytic expansion to the goal using the steer function is tried
+     * every this many expansions.
+     */
+    Property<unsigned int> analytic_expansion_interval{
+        5, "analytic_expansion_interval", this};
+
+    /**
+     * Look up the non-holonomic distance to the goal ignoring obstacles in a
+     * precomputed Reeds-Shepp or Dubins distance table (see
+     * steer.distance_table) instead of solving it exactly. The interpolated
+     * distances may exceed the exact ones, so the heuristic is no longer
+     * admissible and the search no longer optimal.
+     */
+    Property<bool> nonholonomic_table{false, "nonholonomic_table", this};
+  } hybridAStar{"hybrid_astar", this};
+
   GlobalSettings() : Group("settings") {}
 
   void load(const nlohmann::json &j) {
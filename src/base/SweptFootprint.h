@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ompl/base/State.h>
+
+#include "base/Primitives.h"
+
+/**
+ * Conservative approximation of the area swept by the robot footprint while
+ * it moves between two states along the current steer function.
+ *
+ * The approximation is the convex hull of the footprints at both states,
+ * inflated by how far any point of the robot can deviate from the straight
+ * line between its two placements. A point at distance r from the reference
+ * point travels at most the arc length of the reference point plus r times
+ * the rotation of the robot. A curve of that length between two placements A
+ * and B stays within the ellipse with foci A and B, i.e. within half its minor
+ * axis of the segment AB, which lies inside the convex hull.
+ */
+class SweptFootprint {
+ public:
+  /**
+   * @param shape Footprint of the robot relative to its reference point.
+   * @param curvature Maximum curvature of the reference point's path, or
+   * zero if it moves on straight lines (linear steering).
+   */
+  SweptFootprint(const Polygon &shape, double curvature);
+
+  /**
+   * Maximum curvature of the current steer function as needed by the
+   * constructor.
+   */
+  static double steerCurvature();
+
+  /**
+   * Polygon that contains the footprint at every state between a and b.
+   * @param arc_length Upper bound of the arc length the reference point
+   * travels between a and b.
+   */
+  Polygon hull(const ompl::base::State *a, const ompl::base::State *b,
+               double arc_length) const;
+
+  /**
+   * Distance between the placements of a robot point that bounds the
+   * deviation from the segment between them (see hull()).
+   */
+  double margin(const ompl::base::State *a, const ompl::base::State *b,
+                double arc_length) const;
+
+  /**
+   * Circumscribed radius of the footprint around the reference point.
+   */
+  double radius() const { return radius_; }
+
+ private:
+  Polygon shape_;
+  double radius_{0};
+  double curvature_{0};
+};
@@ -2,13 +2,17 @@
 
 #include <utils/ScenarioLoader.h>
 
+#include <atomic>
 #include <ctime>
 #include <iostream>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <vector>
 
 #include "base/Environment.h"
+#include "base/EnvironmentStore.h"
 #include "base/PlannerSettings.h"
+#include "base/environments/OccupancyPyramid.h"
 
 #define ROS_SUPPORT 0
 #define XML_SUPPORT 0
@@ -29,6 +33,11 @@ class GridMaze : public Environment {
   static inline const unsigned int DefaultWidth = 50;
   static inline const unsigned int DefaultHeight = 50;
 
+  /**
+   * Half width of the square footprint of a point robot in occupied(x, y).
+   */
+  static constexpr double PointFootprint = .15;
+
   unsigned int seed() const { return _seed; }
 
   bool empty() const { return _empty; }
@@ -51,11 +60,11 @@ class GridMaze : public Environment {
     //#endif
     //      return _grid[coord2key(x, y)] || bilinearDistance(x, y) <= 0.1;
     //    }
-    bool c = _grid[coord2key(x, y)] || _grid[coord2key(x + .15, y)] ||
-             _grid[coord2key(x, y + .15)] ||
-             _grid[coord2key(x + .15, y + .15)] ||
-             _grid[coord2key(x - .15, y)] || _grid[coord2key(x, y - .15)] ||
-             _grid[coord2key(x - .15, y - .15)];
+    const double f = PointFootprint;
+    bool c = _grid[coord2key(x, y)] || _grid[coord2key(x + f, y)] ||
+             _grid[coord2key(x, y + f)] || _grid[coord2key(x + f, y + f)] ||
+             _grid[coord2key(x - f, y)] || _grid[coord2key(x, y - f)] ||
+             _grid[coord2key(x - f, y - f)];
 
     _collision_timer.stop();
     return c;
@@ -65,6 +74,29 @@ class GridMaze : public Environment {
     return _grid[yi * _voxels_x + xi];
   }
 
+  /**
+   * Line-of-sight check for the area swept by an axis-aligned square of the
+   * given half width along the segment, which by default covers the footprint
+   * of occupied(x, y). Every cell overlapping the swept area is visited once,
+   * column by column.
+   * @return True if the segment lies within the map and the swept area
+   * touches no occupied cell.
+   */
+  bool thickLineOfSight(double x1, double y1, double x2, double y2,
+                        double half_width = PointFootprint);
+
+  /**
+   * Conservative test whether the robot can move from a to b along any curve
+   * whose reference point travels at most arc_length, for the current
+   * collision model. Such a curve stays within the ellipse with foci a and b,
+   * so the test checks the box around the segment that covers the ellipse
+   * inflated by the robot's footprint against the occupancy pyramid, which
+   * resolves open space in a few steps.
+   * @return True if the motion is free, false if it may collide (or leaves
+   * the map) and has to be checked in detail.
+   */
+  bool motionFree(const ob::State *a, const ob::State *b, double arc_length);
+
   /**
    * Computes distances field if necessary, and returns the distance
    * to the nearest obstacle.
@@ -74,6 +106,15 @@ class GridMaze : public Environment {
     return _distances[coord2key(x, y)];
   }
 
+  /**
+   * Computes distances field if necessary, and returns a lower bound of the
+   * distance a point robot can move before occupied(x, y) holds, or, for a
+   * positive radius, before a polygon within that radius collides. Accounts
+   * for the point footprint, the cells polygons are checked against, the map
+   * boundaries and the discretization of the distance field.
+   */
+  double clearance(double x, double y, double radius = 0) override;
+
   /**
    * Computes distances field if necessary, and returns the distance
    * to the nearest obstacle.
@@ -92,6 +133,24 @@ class GridMaze : public Environment {
     return _distances[yi * _voxels_x + xi];
   }
 
+  /**
+   * Builds the occupancy pyramid if necessary and returns it. Its queries
+   * operate in cell units, i.e. world coordinates divided by the voxel size.
+   * The pyramid is built once (it is also built by computeDistances()), so
+   * concurrent collision checks are safe as long as the grid is not
+   * modified.
+   */
+  inline const OccupancyPyramid &occupancyPyramid() {
+    if (!_occupancy_pyramid_valid.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(_occupancy_pyramid_mutex);
+      if (!_occupancy_pyramid_valid.load(std::memory_order_relaxed)) {
+        _occupancy_pyramid.build(_grid, _voxels_x, _voxels_y);
+        _occupancy_pyramid_valid.store(true, std::memory_order_release);
+      }
+    }
+    return _occupancy_pyramid;
+  }
+
   friend std::ostream &operator<<(std::ostream &stream, const GridMaze &m) {
     for (unsigned int y = 0; y < m._voxels_y; ++y) {
       for (unsigned int x = 0; x < m._voxels_x; ++x) {
@@ -126,6 +185,7 @@ class GridMaze : public Environment {
 
   bool collides(double x, double y) override;
   bool collides(const Polygon &polygon) override;
+  bool collides(const ConvexFootprint &footprint) override;
 
   static std::shared_ptr<GridMaze> createRandom(
       unsigned int width = DefaultWidth, unsigned int height = DefaultHeight,
@@ -144,6 +204,13 @@ class GridMaze : public Environment {
   static std::shared_ptr<GridMaze> createFromMovingAiScenario(
       Scenario &scenario);
 
+  /**
+   * Sets start, goal and name according to the given Moving AI scenario. The
+   * scenario has to refer to the map this grid has been created from, since
+   * the occupancy grid and the distance field are kept.
+   */
+  void setMovingAiScenario(const Scenario &scenario);
+
   /**
    * Creates a map from a grayscale image where tones below the occupancy
    * threshold are considered obstacles. Optional resizing is applied if the
@@ -187,9 +254,21 @@ class GridMaze : public Environment {
     j["seed"] = seed();
     j["start"] = {start().x, start().y, startTheta()};
     j["goal"] = {goal().x, goal().y, goalTheta()};
-    j["map"] = mapString();
     j["name"] = name();
-    if (global::settings.log_env_distances) j["distances"] = mapDistances();
+    nlohmann::json reference;
+    if (global::settings.store_environments) {
+      reference = EnvironmentStore::store(
+          mapString(), voxels_x(), voxels_y(),
+          global::settings.log_env_distances ? mapDistances()
+                                             : std::vector<double>());
+    }
+    if (!reference.is_null()) {
+      j["map_ref"] = reference;
+    } else {
+      // embed the map if it is not (or could not be) stored separately
+      j["map"] = mapString();
+      if (global::settings.log_env_distances) j["distances"] = mapDistances();
+    }
     j["distance_computation_method"] =
         distance_computation::to_string(distanceComputationMethod());
   }
@@ -197,6 +276,8 @@ class GridMaze : public Environment {
  protected:
   using Environment::_collision_timer;
 
+  void hashContent(ContentHash &hash) const override;
+
   inline unsigned int coord2key(double x, double y) const {
     return (unsigned int)std::max(
         0., std::min(std::round(y), _voxels_y - 1.) * _voxels_x +
@@ -223,6 +304,9 @@ class GridMaze : public Environment {
   unsigned int _voxels_y{0};
 
   double *_distances{nullptr};
+  OccupancyPyramid _occupancy_pyramid;
+  std::atomic<bool> _occupancy_pyramid_valid{false};
+  std::mutex _occupancy_pyramid_mutex;
   double _voxelSize{1.0};
   bool _empty{true};
   unsigned int _seed{0};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/**
+ * Min/max pyramid over a binary occupancy grid. Level 0 holds the cells of the
+ * grid, every cell on level k summarizes a block of 2^k x 2^k grid cells by
+ * storing whether the block contains free and/or occupied cells.
+ *
+ * Queries descend from the coarsest level and only refine blocks that are
+ * mixed and overlap the query shape, so that large free (or occupied) regions
+ * are resolved in a few steps. All coordinates are given in cell units, i.e.
+ * grid cell (x, y) covers [x, x+1] x [y, y+1].
+ */
+class OccupancyPyramid {
+ public:
+  enum Flags : unsigned char { FREE = 1u, OCCUPIED = 2u, MIXED = 3u };
+
+  OccupancyPyramid() = default;
+  OccupancyPyramid(const bool *grid, unsigned int width, unsigned int height) {
+    build(grid, width, height);
+  }
+
+  /**
+   * (Re-)builds all levels from the given row-major occupancy grid where true
+   * means occupied.
+   */
+  void build(const bool *grid, unsigned int width, unsigned int height);
+
+  void clear() { _levels.clear(); }
+  bool empty() const { return _levels.empty(); }
+
+  unsigned int levels() const { return (unsigned int)_levels.size(); }
+  unsigned int width() const { return _width; }
+  unsigned int height() const { return _height; }
+
+  /**
+   * Flags of the block at position (x, y) on the given level.
+   */
+  unsigned char flags(unsigned int level, unsigned int x,
+                      unsigned int y) const {
+    const auto &l = _levels[level];
+    return l.flags[y * l.width + x];
+  }
+
+  /**
+   * Checks whether all cells overlapping the axis-aligned box are free.
+   */
+  bool boxFree(double x1, double y1, double x2, double y2) const;
+  /**
+   * Checks whether all cells overlapping the axis-aligned box are occupied.
+   */
+  bool boxOccupied(double x1, double y1, double x2, double y2) const;
+
+  /**
+   * Checks whether all cells overlapping the disk are free.
+   */
+  bool diskFree(double x, double y, double radius) const;
+  /**
+   * Checks whether all cells overlapping the disk are occupied.
+   */
+  bool diskOccupied(double x, double y, double radius) const;
+
+  /**
+   * Checks whether all cells are free that overlap the oriented box around
+   * the segment from (x1, y1) to (x2, y2), inflated by half_width in every
+   * direction. This box covers the sweep of a footprint with circumradius
+   * half_width along the segment.
+   */
+  bool sweptBoxFree(double x1, double y1, double x2, double y2,
+                    double half_width) const;
+  /**
+   * Checks whether all cells are occupied that overlap the swept box as
+   * defined for sweptBoxFree().
+   */
+  bool sweptBoxOccupied(double x1, double y1, double x2, double y2,
+                        double half_width) const;
+
+  /**
+   * Determines whether any occupied cell intersects a shape. The shape is
+   * given by a predicate intersects(x1, y1, x2, y2) that tells whether the
+   * shape intersects the given rectangle (in cell units). It is evaluated on
+   * coarse blocks first, so it has to be exact (or conservative) for
+   * arbitrary rectangles, not just single cells.
+   */
+  template <class Intersects>
+  bool containsOccupied(const Intersects &intersects) const {
+    return contains<OCCUPIED>(intersects);
+  }
+
+  /**
+   * Determines whether any free cell intersects a shape, see
+   * containsOccupied().
+   */
+  template <class Intersects>
+  bool containsFree(const Intersects &intersects) const {
+    return contains<FREE>(intersects);
+  }
+
+ private:
+  struct Level {
+    unsigned int width{0};
+    unsigned int height{0};
+    std::vector<unsigned char> flags;
+  };
+
+  template <unsigned char Flag, class Intersects>
+  bool contains(const Intersects &intersects) const {
+    if (_levels.empty()) return false;
+
+    struct Node {
+      unsigned int level, x, y;
+    };
+    // depth-first traversal pushes at most three siblings per level
+    std::array<Node, 4 * 33> stack;
+    std::size_t size = 0;
+    stack[size++] = {levels() - 1, 0, 0};
+    while (size > 0) {
+      const Node node = stack[--size];
+      const unsigned char f = flags(node.level, node.x, node.y);
+      if (!(f & Flag)) continue;
+      const double x1 = node.x << node.level;
+      const double y1 = node.y << node.level;
+      const double x2 = std::min((node.x + 1) << node.level, _width);
+      const double y2 = std::min((node.y + 1) << node.level, _height);
+      if (!intersects(x1, y1, x2, y2)) continue;
+      // the whole block agrees with the query
+      if (f == Flag) return true;
+      const auto &child = _levels[node.level - 1];
+      for (unsigned int dy = 0; dy < 2; ++dy) {
+        const unsigned int cy = 2 * node.y + dy;
+        if (cy >= child.height) break;
+        for (unsigned int dx = 0; dx < 2; ++dx) {
+          const unsigned int cx = 2 * node.x + dx;
+          if (cx >= child.width) break;
+          stack[size++] = {node.level - 1, cx, cy};
+        }
+      }
+    }
+    return false;
+  }
+
+  unsigned int _width{0};
+  unsigned int _height{0};
+  std::vector<Level> _levels;
+};
@@ -21,31 +21,30 @@ class PolygonMaze : public Environment {
   static std::shared_ptr<PolygonMaze> loadFromSvg(const std::string &filename) {
     auto maze = std::make_shared<PolygonMaze>();
     maze->_name += " " + filename;
-    maze->_obstacles = SvgPolygonLoader::load(filename);
-    if (maze->_obstacles.empty()) {
+    auto obstacles = SvgPolygonLoader::load(filename);
+    if (obstacles.empty()) {
       OMPL_ERROR(
           ("Could not find any obstacles in \"" + filename + "\".").c_str());
       return maze;
     }
-    for (auto &obstacle : maze->_obstacles)
+    for (auto &obstacle : obstacles)
       obstacle.scale(global::settings.env.polygon.scaling);
-    auto min = maze->_obstacles[0].min();
-    auto max = maze->_obstacles[0].max();
-    for (const auto &o : maze->_obstacles) {
-      const auto new_min = o.min();
-      const auto new_max = o.max();
-      if (new_min.x < min.x) min.x = new_min.x;
-      if (new_max.x > max.x) max.x = new_max.x;
-      if (new_min.y < min.y) min.y = new_min.y;
-      if (new_max.y > max.y) max.y = new_max.y;
-    }
-    maze->_bounds.setLow(0, min.x);
-    maze->_bounds.setLow(1, min.y);
-    maze->_bounds.setHigh(0, max.x);
-    maze->_bounds.setHigh(1, max.y);
+    maze->setObstacles(obstacles);
     OMPL_INFORM(("Loaded polygon maze from \"" + filename + "\".").c_str());
-    OMPL_INFORM("\tBounds:  [%.2f %.2f] -- [%.2f %.2f]", min.x, min.y, max.x,
-                max.y);
+    OMPL_INFORM("\tBounds:  [%.2f %.2f] -- [%.2f %.2f]", maze->_bounds.low[0],
+                maze->_bounds.low[1], maze->_bounds.high[0],
+                maze->_bounds.high[1]);
+    return maze;
+  }
+
+  /**
+   * Creates a maze from the given (unscaled) obstacles, whose bounding box
+   * determines the bounds of the maze.
+   */
+  static std::shared_ptr<PolygonMaze> createFromObstacles(
+      const std::vector<Polygon> &obstacles) {
+    auto maze = std::make_shared<PolygonMaze>();
+    if (!obstacles.empty()) maze->setObstacles(obstacles);
     return maze;
   }
 
@@ -64,18 +63,25 @@ class PolygonMaze : public Environment {
     return false;
   }
   bool collides(const Polygon &polygon) override {
+    // transformed footprints and swept hulls differ on every call, so the
+    // footprint is built on the stack instead of being cached
+    ConvexFootprint footprint;
+    if (footprint.assign(polygon)) return collides(footprint);
     for (const auto &poly : _obstacles) {
       if (collision2d::intersect((collision2d::Polygon<double>)polygon,
                                  (collision2d::Polygon<double>)poly)) {
-        // std::cerr << "Intersection between polygons " << polygon.min() << " "
-        //          << polygon.max() << " and " << poly.min() << " " <<
-        //          poly.max()
-        //          << std::endl;
         return true;
       }
     }
     return false;
   }
+  bool collides(const ConvexFootprint &footprint) override {
+    const auto view = footprint.view();
+    for (const auto &poly : _convex_obstacles) {
+      if (sat::intersects(view, poly.view())) return true;
+    }
+    return false;
+  }
 
   void to_json(nlohmann::json &j) override {
     j["type"] = "polygon";
@@ -93,7 +99,40 @@ class PolygonMaze : public Environment {
 
   double unit() const override { return .2; }
 
+ protected:
+  void hashContent(ContentHash &hash) const override {
+    Environment::hashContent(hash);
+    for (const auto &obstacle : _obstacles) {
+      hash.add(obstacle.points.size());
+      for (const auto &p : obstacle.points) hash.add(p.x).add(p.y);
+    }
+  }
+
  private:
+  void setObstacles(const std::vector<Polygon> &obstacles) {
+    invalidateContentHash();
+    _obstacles = obstacles;
+    _convex_obstacles.clear();
+    for (const auto &obstacle : _obstacles)
+      _convex_obstacles.emplace_back(obstacle);
+    auto min = _obstacles[0].min();
+    auto max = _obstacles[0].max();
+    for (const auto &o : _obstacles) {
+      const auto new_min = o.min();
+      const auto new_max = o.max();
+      if (new_min.x < min.x) min.x = new_min.x;
+      if (new_max.x > max.x) max.x = new_max.x;
+      if (new_min.y < min.y) min.y = new_min.y;
+      if (new_max.y > max.y) max.y = new_max.y;
+    }
+    _bounds.setLow(0, min.x);
+    _bounds.setLow(1, min.y);
+    _bounds.setHigh(0, max.x);
+    _bounds.setHigh(1, max.y);
+  }
+
   std::string _name{"polygon_maze"};
   std::vector<Polygon> _obstacles;
+  // obstacles with precomputed edge normals for the footprint checks
+  std::vector<ConvexPolygon> _convex_obstacles;
 };
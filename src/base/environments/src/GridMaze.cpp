@@ -72,11 +72,21 @@ GridMaze::~GridMaze() {
   delete[] _distances;
 }
 
+void GridMaze::hashContent(ContentHash &hash) const {
+  Environment::hashContent(hash);
+  hash.add(_voxels_x).add(_voxels_y).add(_voxelSize);
+  hash.add(_grid, cells() * sizeof(bool));
+}
+
 void GridMaze::fill(double x, double y, bool value) {
   _grid[coord2key(x, y)] = value;
+  _occupancy_pyramid_valid = false;
+  invalidateContentHash();
 }
 
 void GridMaze::fill(const Rectangle &r, bool value) {
+  _occupancy_pyramid_valid = false;
+  invalidateContentHash();
   for (int x = (int)std::floor(std::max(0., std::min(r.x1, r.x2)));
        x < std::ceil(std::min(width(), std::max(r.x1, r.x2))); ++x) {
     for (int y = (int)std::floor(std::max(0., std::min(r.y1, r.y2)));
@@ -355,6 +365,12 @@ void GridMaze::publish(ros::NodeHandle &nodeHandle) const {
 bool GridMaze::collides(double x, double y) { return occupied(x, y); }
 
 bool GridMaze::collides(const Polygon &polygon) {
+  // transformed footprints and swept hulls differ on every call, so the
+  // footprint is built on the stack instead of being cached
+  ConvexFootprint footprint;
+  if (footprint.assign(polygon)) return collides(footprint);
+
+  // polygons that exceed the footprint capacity are checked cell by cell
   _collision_timer.resume();
   typedef std::vector<Eigen::Matrix<double, 2, 1>> PG;
   const auto poly = (PG)polygon;
@@ -396,6 +412,127 @@ bool GridMaze::collides(const Polygon &polygon) {
   return false;
 }
 
+bool GridMaze::collides(const ConvexFootprint &footprint) {
+  const auto &pyramid = occupancyPyramid();
+  _collision_timer.resume();
+  const auto view = footprint.view();
+  const bool collides = pyramid.containsOccupied(
+      [&](double x1, double y1, double x2, double y2) {
+        return sat::intersectsBox(view, x1 * _voxelSize, y1 * _voxelSize,
+                                  x2 * _voxelSize, y2 * _voxelSize);
+      });
+  _collision_timer.stop();
+  return collides;
+}
+
+bool GridMaze::motionFree(const ob::State *a, const ob::State *b,
+                          double arc_length) {
+  const auto *sa = a->as<State>(), *sb = b->as<State>();
+  const double x1 = sa->getX(), y1 = sa->getY();
+  const double x2 = sb->getX(), y2 = sb->getY();
+  // half the minor axis of the ellipse, which also bounds how far the curve
+  // extends beyond a and b along the segment
+  const double d = std::hypot(x2 - x1, y2 - y1);
+  const double length = std::max(arc_length, d);
+  double half_width = .5 * std::sqrt(length * length - d * d);
+  // conversion to the cell units of the pyramid, where cell x spans [x, x+1]
+  double offset, scale;
+  if (global::settings.env.collision.collision_model == robot::ROBOT_POINT) {
+    // occupied(x, y) rounds the coordinates to the nearest cell and checks
+    // the square of half width PointFootprint around the point
+    half_width += std::sqrt(2.) * PointFootprint;
+    offset = .5;
+    scale = 1.;
+  } else {
+    double radius = 0;
+    for (const auto &p :
+         global::settings.env.collision.robot_shape.value().points)
+      radius = std::max(radius, std::hypot(p.x, p.y));
+    half_width += radius;
+    offset = 0.;
+    scale = 1. / _voxelSize;
+  }
+  // the swept box reaches half_width beyond the segment in every direction
+  const double margin = std::sqrt(2.) * half_width;
+  if (std::min(x1, x2) - margin < 0 || std::min(y1, y2) - margin < 0 ||
+      std::max(x1, x2) + margin > width() ||
+      std::max(y1, y2) + margin > height())
+    return false;
+  const auto &pyramid = occupancyPyramid();
+  _collision_timer.resume();
+  const bool free = pyramid.sweptBoxFree(
+      x1 * scale + offset, y1 * scale + offset, x2 * scale + offset,
+      y2 * scale + offset, half_width * scale);
+  _collision_timer.stop();
+  return free;
+}
+
+double GridMaze::clearance(double x, double y, double radius) {
+  if (x < 0 || y < 0 || x > width() || y > height()) return 0;
+  // distances are computed between the cells around integer coordinates, so
+  // the point may be off by half a cell diagonal
+  double margin = std::sqrt(.5);
+  if (radius > 0) {
+    // polygons are checked against the cells spanning [x, x+1) x [y, y+1),
+    // which reach a full cell diagonal beyond the cell center
+    margin += std::sqrt(2.) + radius;
+  } else {
+    // occupied(x, y) inflates the cells by the point footprint
+    margin += std::sqrt(2.) * (.5 + PointFootprint);
+  }
+  // dead reckoning may overestimate the distance by a fraction of a cell
+  if (distanceComputationMethod() == distance_computation::DEAD_RECKONING)
+    margin += .5;
+  const double d = distance(x, y) - margin;
+  return std::min(d, std::min(std::min(x, width() - x),
+                              std::min(y, height() - y)));
+}
+
+bool GridMaze::thickLineOfSight(double x1, double y1, double x2, double y2,
+                                double half_width) {
+  if (x1 < 0 || y1 < 0 || x1 > width() || y1 > height() || x2 < 0 ||
+      y2 < 0 || x2 > width() || y2 > height())
+    return false;
+  _collision_timer.resume();
+  const auto clamp_x = [this](double x) {
+    return std::max(0l, std::min((long)std::floor(x), (long)_voxels_x - 1));
+  };
+  const auto clamp_y = [this](double y) {
+    return std::max(0l, std::min((long)std::floor(y), (long)_voxels_y - 1));
+  };
+
+  // shift coordinates such that cell (x, y) covers [x, x+1] x [y, y+1]
+  double u1 = x1 + .5, v1 = y1 + .5;
+  double u2 = x2 + .5, v2 = y2 + .5;
+  if (u1 > u2) {
+    std::swap(u1, u2);
+    std::swap(v1, v2);
+  }
+  const double h = half_width;
+  const double slope = u2 > u1 ? (v2 - v1) / (u2 - u1) : 0.;
+
+  for (long x = clamp_x(u1 - h); x <= clamp_x(u2 + h); ++x) {
+    // part of the segment whose footprint reaches into this column, the
+    // border columns also cover everything beyond the map
+    const double a = x > 0 ? std::max(u1, x - h) : u1;
+    const double b = x + 1 < (long)_voxels_x ? std::min(u2, x + 1 + h) : u2;
+    double va = v1, vb = v2;
+    if (u2 > u1) {
+      va = v1 + (a - u1) * slope;
+      vb = v1 + (b - u1) * slope;
+    }
+    const long end_y = clamp_y(std::max(va, vb) + h);
+    for (long y = clamp_y(std::min(va, vb) - h); y <= end_y; ++y) {
+      if (occupiedCell((unsigned int)x, (unsigned int)y)) {
+        _collision_timer.stop();
+        return false;
+      }
+    }
+  }
+  _collision_timer.stop();
+  return true;
+}
+
 std::vector<Rectangle> GridMaze::obstacles() const {
   std::vector<Rectangle> obs;
   for (unsigned int x = 0; x < width(); ++x) {
@@ -560,6 +697,8 @@ void GridMaze::computeDistances() {
       }
     }
   }
+  // build the pyramid before collision checks may run concurrently
+  occupancyPyramid();
 }
 
 shared_ptr<GridMaze> GridMaze::createSimple() {
@@ -577,13 +716,10 @@ std::shared_ptr<GridMaze> GridMaze::createFromMovingAiScenario(
   auto environment =
       std::make_shared<GridMaze>(0, scenario.map_width, scenario.map_height);
   // set start and goal points
-  environment->setStart(Point(scenario.start_x, scenario.start_y));
-  environment->setGoal(Point(scenario.goal_x, scenario.goal_y));
+  environment->setMovingAiScenario(scenario);
   environment->_voxels_x = scenario.map_width;
   environment->_voxels_y = scenario.map_height;
   environment->_type = "moving_ai " + scenario.mapName;
-  environment->_name =
-      scenario.filename + "[" + std::to_string(scenario.id) + "]";
 
   // construct map
   const auto &grid = scenario.getMap();
@@ -602,6 +738,12 @@ std::shared_ptr<GridMaze> GridMaze::createFromMovingAiScenario(
   return environment;
 }
 
+void GridMaze::setMovingAiScenario(const Scenario &scenario) {
+  setStart(Point(scenario.start_x, scenario.start_y));
+  setGoal(Point(scenario.goal_x, scenario.goal_y));
+  _name = scenario.filename + "[" + std::to_string(scenario.id) + "]";
+}
+
 std::shared_ptr<GridMaze> GridMaze::createFromImage(const std::string &filename,
                                     double occupancy_threshold, int width,
                                     int height) {
@@ -0,0 +1,128 @@
+#include "base/environments/OccupancyPyramid.h"
+
+#include <cmath>
+
+namespace {
+struct BoxOverlap {
+  double x1, y1, x2, y2;
+
+  bool operator()(double bx1, double by1, double bx2, double by2) const {
+    return bx1 <= x2 && bx2 >= x1 && by1 <= y2 && by2 >= y1;
+  }
+};
+
+struct DiskOverlap {
+  double x, y, radius;
+
+  bool operator()(double bx1, double by1, double bx2, double by2) const {
+    // closest point of the rectangle to the center
+    const double dx = x - std::max(bx1, std::min(x, bx2));
+    const double dy = y - std::max(by1, std::min(y, by2));
+    return dx * dx + dy * dy <= radius * radius;
+  }
+};
+
+/**
+ * Separating axis test between an oriented box (center, unit axis u,
+ * half extents) and axis-aligned rectangles.
+ */
+struct OrientedBoxOverlap {
+  double cx, cy, ux, uy, half_length, half_width;
+  // axis-aligned bounding box of the oriented box
+  BoxOverlap bounds;
+
+  OrientedBoxOverlap(double x1, double y1, double x2, double y2, double w) {
+    const double length = std::hypot(x2 - x1, y2 - y1);
+    cx = (x1 + x2) * 0.5;
+    cy = (y1 + y2) * 0.5;
+    if (length > 1e-9) {
+      ux = (x2 - x1) / length;
+      uy = (y2 - y1) / length;
+    } else {
+      ux = 1.;
+      uy = 0.;
+    }
+    half_length = length * 0.5 + w;
+    half_width = w;
+    const double ex = std::abs(ux) * half_length + std::abs(uy) * half_width;
+    const double ey = std::abs(uy) * half_length + std::abs(ux) * half_width;
+    bounds = {cx - ex, cy - ey, cx + ex, cy + ey};
+  }
+
+  bool operator()(double bx1, double by1, double bx2, double by2) const {
+    if (!bounds(bx1, by1, bx2, by2)) return false;
+    const double rx = (bx2 - bx1) * 0.5;
+    const double ry = (by2 - by1) * 0.5;
+    const double dx = (bx1 + bx2) * 0.5 - cx;
+    const double dy = (by1 + by2) * 0.5 - cy;
+    // axis along the segment
+    if (std::abs(dx * ux + dy * uy) >
+        half_length + rx * std::abs(ux) + ry * std::abs(uy))
+      return false;
+    // axis normal to the segment
+    return std::abs(-dx * uy + dy * ux) <=
+           half_width + rx * std::abs(uy) + ry * std::abs(ux);
+  }
+};
+}  // namespace
+
+void OccupancyPyramid::build(const bool *grid, unsigned int width,
+                             unsigned int height) {
+  _levels.clear();
+  _width = width;
+  _height = height;
+  if (width == 0 || height == 0) return;
+
+  Level base;
+  base.width = width;
+  base.height = height;
+  base.flags.resize((std::size_t)width * height);
+  for (std::size_t i = 0; i < base.flags.size(); ++i)
+    base.flags[i] = grid[i] ? OCCUPIED : FREE;
+  _levels.emplace_back(std::move(base));
+
+  while (_levels.back().width > 1 || _levels.back().height > 1) {
+    const Level &fine = _levels.back();
+    Level coarse;
+    coarse.width = (fine.width + 1) / 2;
+    coarse.height = (fine.height + 1) / 2;
+    coarse.flags.assign((std::size_t)coarse.width * coarse.height, 0);
+    for (unsigned int y = 0; y < fine.height; ++y) {
+      for (unsigned int x = 0; x < fine.width; ++x) {
+        coarse.flags[(y / 2) * coarse.width + x / 2] |=
+            fine.flags[y * fine.width + x];
+      }
+    }
+    _levels.emplace_back(std::move(coarse));
+  }
+}
+
+bool OccupancyPyramid::boxFree(double x1, double y1, double x2,
+                               double y2) const {
+  return !containsOccupied(BoxOverlap{std::min(x1, x2), std::min(y1, y2),
+                                      std::max(x1, x2), std::max(y1, y2)});
+}
+
+bool OccupancyPyramid::boxOccupied(double x1, double y1, double x2,
+                                   double y2) const {
+  return !containsFree(BoxOverlap{std::min(x1, x2), std::min(y1, y2),
+                                  std::max(x1, x2), std::max(y1, y2)});
+}
+
+bool OccupancyPyramid::diskFree(double x, double y, double radius) const {
+  return !containsOccupied(DiskOverlap{x, y, radius});
+}
+
+bool OccupancyPyramid::diskOccupied(double x, double y, double radius) const {
+  return !containsFree(DiskOverlap{x, y, radius});
+}
+
+bool OccupancyPyramid::sweptBoxFree(double x1, double y1, double x2,
+                                    double y2, double half_width) const {
+  return !containsOccupied(OrientedBoxOverlap(x1, y1, x2, y2, half_width));
+}
+
+bool OccupancyPyramid::sweptBoxOccupied(double x1, double y1, double x2,
+                                        double y2, double half_width) const {
+  return !containsFree(OrientedBoxOverlap(x1, y1, x2, y2, half_width));
+}
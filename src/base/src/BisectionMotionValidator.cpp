@@ -0,0 +1,164 @@
+#include "base/BisectionMotionValidator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "base/PlannerSettings.h"
+#include "base/environments/GridMaze.h"
+
+BisectionMotionValidator::BisectionMotionValidator(
+    const ob::SpaceInformationPtr &si, const std::shared_ptr<Environment> &env)
+    : ob::MotionValidator(si),
+      env_(env),
+      grid_(dynamic_cast<GridMaze *>(env.get())) {
+  if (global::settings.env.collision.collision_model == robot::ROBOT_POLYGON)
+    footprint_ = std::make_unique<SweptFootprint>(
+        global::settings.env.collision.robot_shape.value(),
+        SweptFootprint::steerCurvature());
+}
+
+bool BisectionMotionValidator::supportsSteering() {
+  // POSQ and clothoids come with their own motion validators
+  return global::settings.steer.steering_type != Steering::STEER_TYPE_POSQ &&
+         global::settings.steer.steering_type != Steering::STEER_TYPE_CLOTHOID;
+}
+
+bool BisectionMotionValidator::checkMotion(const ob::State *s1,
+                                           const ob::State *s2) const {
+  return check(s1, s2, nullptr);
+}
+
+bool BisectionMotionValidator::checkMotion(
+    const ob::State *s1, const ob::State *s2,
+    std::pair<ob::State *, double> &lastValid) const {
+  return check(s1, s2, &lastValid);
+}
+
+bool BisectionMotionValidator::checkElement(const ob::State *s1,
+                                            const ob::State *s2,
+                                            unsigned int i, unsigned int n,
+                                            double length,
+                                            ob::State *const *scratch) const {
+  if (footprint_)
+    return checkSweptSegment(s1, s2, (i - 1.) / n, (double)i / n, length,
+                             scratch);
+  if (i == n) return si_->isValid(s2);
+  si_->getStateSpace()->interpolate(s1, s2, (double)i / n, scratch[0]);
+  return si_->isValid(scratch[0]);
+}
+
+bool BisectionMotionValidator::sweptFree(const ob::State *s1,
+                                         const ob::State *s2, double t1,
+                                         double t2, double length,
+                                         ob::State *const *scratch) const {
+  const auto &space = si_->getStateSpace();
+  const ob::State *a = s1, *b = s2;
+  if (t1 > 0) {
+    space->interpolate(s1, s2, t1, scratch[0]);
+    a = scratch[0];
+  }
+  if (t2 < 1) {
+    space->interpolate(s1, s2, t2, scratch[1]);
+    b = scratch[1];
+  }
+  return !env_->collides(footprint_->hull(a, b, length * (t2 - t1)));
+}
+
+bool BisectionMotionValidator::checkSweptSegment(
+    const ob::State *s1, const ob::State *s2, double t1, double t2,
+    double length, ob::State *const *scratch) const {
+  // segments whose swept area collides are halved until they are as short as
+  // the state validity checking resolution, where the inflation of the hull
+  // vanishes and a remaining collision is considered real
+  const double min_length =
+      si_->getStateValidityCheckingResolution() * si_->getMaximumExtent();
+  struct Interval {
+    double t1, t2;
+  };
+  // depth-first refinement pushes at most one interval per level
+  std::array<Interval, 64> stack;
+  std::size_t size = 0;
+  stack[size++] = {t1, t2};
+  while (size > 0) {
+    const Interval interval = stack[--size];
+    if (sweptFree(s1, s2, interval.t1, interval.t2, length, scratch))
+      continue;
+    if ((interval.t2 - interval.t1) * length <= min_length ||
+        size + 2 > stack.size())
+      return false;
+    const double mid = .5 * (interval.t1 + interval.t2);
+    // a colliding intermediate state ends the check right away
+    si_->getStateSpace()->interpolate(s1, s2, mid, scratch[0]);
+    if (!si_->isValid(scratch[0])) return false;
+    stack[size++] = {mid, interval.t2};
+    stack[size++] = {interval.t1, mid};
+  }
+  return true;
+}
+
+bool BisectionMotionValidator::check(
+    const ob::State *s1, const ob::State *s2,
+    std::pair<ob::State *, double> *lastValid) const {
+  const auto &space = si_->getStateSpace();
+  // exact steer length, which bounds the arc length the swept hulls are
+  // inflated by, never looked up in the distance table
+  const double length = space->distance(s1, s2);
+  if (grid_ != nullptr && grid_->motionFree(s1, s2, length)) {
+    valid_++;
+    return true;
+  }
+  unsigned int n;
+  if (footprint_) {
+    const double segment =
+        global::settings.env.collision.swept_segment_length;
+    n = std::max(1u, (unsigned int)std::ceil(length / segment));
+  } else {
+    n = std::max(1u, space->validSegmentCount(s1, s2));
+  }
+
+  ob::State *scratch[2] = {si_->allocState(), si_->allocState()};
+
+  /* assume motion starts in a valid configuration so s1 is valid */
+  // the end of the motion is checked first, then the remaining elements from
+  // coarse to fine: every index below n is visited once at the stride of its
+  // lowest set bit
+  unsigned int first_invalid = 0;
+  if (!checkElement(s1, s2, n, n, length, scratch)) {
+    first_invalid = n;
+  } else {
+    unsigned int top = 1;
+    while (top < n) top <<= 1;
+    for (unsigned int stride = top; stride > 0 && first_invalid == 0;
+         stride >>= 1) {
+      for (unsigned int i = stride; i < n; i += 2 * stride) {
+        if (!checkElement(s1, s2, i, n, length, scratch)) {
+          first_invalid = i;
+          break;
+        }
+      }
+    }
+  }
+
+  const bool result = first_invalid == 0;
+  if (!result && lastValid != nullptr) {
+    // the earliest invalid element precedes the one found first
+    for (unsigned int i = 1; i < first_invalid; ++i) {
+      if (!checkElement(s1, s2, i, n, length, scratch)) {
+        first_invalid = i;
+        break;
+      }
+    }
+    lastValid->second = (first_invalid - 1.) / n;
+    if (lastValid->first != nullptr)
+      space->interpolate(s1, s2, lastValid->second, lastValid->first);
+  }
+  si_->freeState(scratch[0]);
+  si_->freeState(scratch[1]);
+
+  if (result)
+    valid_++;
+  else
+    invalid_++;
+  return result;
+}
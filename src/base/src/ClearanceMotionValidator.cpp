@@ -0,0 +1,83 @@
+#include "base/ClearanceMotionValidator.h"
+
+#include <cmath>
+
+#include "base/PlannerSettings.h"
+
+ClearanceMotionValidator::ClearanceMotionValidator(
+    const ob::SpaceInformationPtr &si, const std::shared_ptr<Environment> &env)
+    : ob::MotionValidator(si), env_(env) {
+  if (global::settings.env.collision.collision_model == robot::ROBOT_POLYGON) {
+    const auto &shape = global::settings.env.collision.robot_shape.value();
+    for (const auto &p : shape.points)
+      radius_ = std::max(radius_, std::sqrt(p.x * p.x + p.y * p.y));
+  }
+}
+
+bool ClearanceMotionValidator::supportsSteering() {
+  // POSQ and clothoids come with their own motion validators
+  return global::settings.steer.steering_type != Steering::STEER_TYPE_POSQ &&
+         global::settings.steer.steering_type != Steering::STEER_TYPE_CLOTHOID;
+}
+
+bool ClearanceMotionValidator::checkMotion(const ob::State *s1,
+                                           const ob::State *s2) const {
+  return check(s1, s2, nullptr);
+}
+
+bool ClearanceMotionValidator::checkMotion(
+    const ob::State *s1, const ob::State *s2,
+    std::pair<ob::State *, double> &lastValid) const {
+  return check(s1, s2, &lastValid);
+}
+
+bool ClearanceMotionValidator::check(
+    const ob::State *s1, const ob::State *s2,
+    std::pair<ob::State *, double> *lastValid) const {
+  /* assume motion starts in a valid configuration so s1 is valid */
+  if (lastValid == nullptr && !si_->isValid(s2)) {
+    invalid_++;
+    return false;
+  }
+
+  const auto &space = si_->getStateSpace();
+  // exact steer length, never looked up in the distance table
+  const double length = space->distance(s1, s2);
+  const unsigned int nd = std::max(1u, space->validSegmentCount(s1, s2));
+  const double min_step = 1. / nd;
+
+  bool result = true;
+  double t = 0, last_valid_t = 0;
+  ob::State *test = si_->allocState();
+  const ob::State *current = s1;
+  while (true) {
+    const auto *s = current->as<State>();
+    const double free = env_->clearance(s->getX(), s->getY(), radius_);
+    double step = min_step;
+    if (free > 0 && length > 0) step = std::max(step, free / length);
+    t += step;
+    if (t >= 1) break;
+
+    space->interpolate(s1, s2, t, test);
+    if (!si_->isValid(test)) {
+      result = false;
+      break;
+    }
+    last_valid_t = t;
+    current = test;
+  }
+  if (result && lastValid != nullptr && !si_->isValid(s2)) result = false;
+
+  if (!result && lastValid != nullptr) {
+    lastValid->second = last_valid_t;
+    if (lastValid->first != nullptr)
+      space->interpolate(s1, s2, last_valid_t, lastValid->first);
+  }
+  si_->freeState(test);
+
+  if (result)
+    valid_++;
+  else
+    invalid_++;
+  return result;
+}
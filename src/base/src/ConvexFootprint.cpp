@@ -0,0 +1,110 @@
+#include "base/ConvexFootprint.h"
+
+namespace {
+/**
+ * Computes the outward edge normals of the convex polygon with the given
+ * vertices, which may be ordered clockwise or counterclockwise.
+ */
+void edgeNormals(const double *x, const double *y, std::size_t n, double *nx,
+                 double *ny) {
+  double area = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::size_t j = (i + 1) % n;
+    area += x[i] * y[j] - x[j] * y[i];
+  }
+  const double sign = area >= 0 ? 1. : -1.;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::size_t j = (i + 1) % n;
+    nx[i] = sign * (y[j] - y[i]);
+    ny[i] = -sign * (x[j] - x[i]);
+  }
+}
+
+const Polygon &convexOrHull(const Polygon &polygon, Polygon &hull) {
+  if (polygon.isConvex()) return polygon;
+  hull = polygon.convexHull();
+  return hull;
+}
+}  // namespace
+
+bool ConvexFootprint::assign(const Polygon &polygon) {
+  size_ = 0;
+  Polygon hull;
+  const auto &convex = convexOrHull(polygon, hull);
+  if (convex.points.size() < 3 || convex.points.size() > Capacity)
+    return false;
+  size_ = convex.points.size();
+  for (std::size_t i = 0; i < size_; ++i) {
+    x_[i] = convex.points[i].x;
+    y_[i] = convex.points[i].y;
+  }
+  edgeNormals(x_, y_, size_, nx_, ny_);
+  updateBounds();
+  return true;
+}
+
+void ConvexFootprint::transform(double x, double y, double yaw,
+                                ConvexFootprint &out) const {
+  const double c = std::cos(yaw), s = std::sin(yaw);
+  out.size_ = size_;
+  for (std::size_t i = 0; i < size_; ++i) {
+    out.x_[i] = x + x_[i] * c - y_[i] * s;
+    out.y_[i] = y + x_[i] * s + y_[i] * c;
+    out.nx_[i] = nx_[i] * c - ny_[i] * s;
+    out.ny_[i] = nx_[i] * s + ny_[i] * c;
+  }
+  out.updateBounds();
+}
+
+Polygon ConvexFootprint::polygon() const {
+  Polygon p;
+  p.points.reserve(size_);
+  for (std::size_t i = 0; i < size_; ++i) p.points.emplace_back(x_[i], y_[i]);
+  return p;
+}
+
+const ConvexFootprint *CachedConvexFootprint::get(const Polygon &polygon) {
+  const bool changed =
+      polygon.points.size() != points_.size() ||
+      !std::equal(polygon.points.begin(), polygon.points.end(),
+                  points_.begin(), [](const Point &a, const Point &b) {
+                    return a.x == b.x && a.y == b.y;
+                  });
+  if (changed) {
+    points_ = polygon.points;
+    fits_ = footprint_.assign(polygon);
+  }
+  return fits_ ? &footprint_ : nullptr;
+}
+
+void ConvexFootprint::updateBounds() {
+  if (size_ == 0) return;
+  min_x_ = max_x_ = x_[0];
+  min_y_ = max_y_ = y_[0];
+  for (std::size_t i = 1; i < size_; ++i) {
+    min_x_ = std::min(min_x_, x_[i]);
+    max_x_ = std::max(max_x_, x_[i]);
+    min_y_ = std::min(min_y_, y_[i]);
+    max_y_ = std::max(max_y_, y_[i]);
+  }
+}
+
+ConvexPolygon::ConvexPolygon(const Polygon &polygon) {
+  Polygon hull;
+  const auto &convex = convexOrHull(polygon, hull);
+  const std::size_t n = convex.points.size();
+  x_.resize(n);
+  y_.resize(n);
+  nx_.resize(n);
+  ny_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x_[i] = convex.points[i].x;
+    y_[i] = convex.points[i].y;
+  }
+  if (n == 0) return;
+  edgeNormals(x_.data(), y_.data(), n, nx_.data(), ny_.data());
+  min_x_ = *std::min_element(x_.begin(), x_.end());
+  max_x_ = *std::max_element(x_.begin(), x_.end());
+  min_y_ = *std::min_element(y_.begin(), y_.end());
+  max_y_ = *std::max_element(y_.begin(), y_.end());
+}
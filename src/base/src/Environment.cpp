@@ -28,8 +28,7 @@ bool Environment::checkValidity(const ob::State *state) {
     _collision_timer.stop();
     return valid;
   } else {
-    bool valid = !global::settings.environment->collides(
-        global::settings.env.collision.robot_shape.value().transformed(state));
+    bool valid = !global::settings.environment->collidesFootprint(state);
     _collision_timer.stop();
     // if (!valid) {
     //   const auto *s = state->as<ob::SE2StateSpace::StateType>();
@@ -40,6 +39,33 @@ bool Environment::checkValidity(const ob::State *state) {
   }
 }
 
+bool Environment::collidesFootprint(const ob::State *state) {
+  const auto &shape = global::settings.env.collision.robot_shape.value();
+  // the footprint is rebuilt whenever the robot shape changes
+  thread_local CachedConvexFootprint cache;
+  const ConvexFootprint *footprint = cache.get(shape);
+  if (footprint == nullptr) return collides(shape.transformed(state));
+  ConvexFootprint placed;
+  footprint->transform(state, placed);
+  return collides(placed);
+}
+
+std::uint64_t Environment::contentHash() const {
+  std::uint64_t hash = _content_hash;
+  if (hash != 0) return hash;
+  // threads computing the hash concurrently store the same value
+  ContentHash content;
+  hashContent(content);
+  hash = std::max<std::uint64_t>(1, content.value());
+  _content_hash = hash;
+  return hash;
+}
+
+void Environment::hashContent(ContentHash &hash) const {
+  for (unsigned int i = 0; i < 2; ++i)
+    hash.add(_bounds.low[i]).add(_bounds.high[i]);
+}
+
 double Environment::bilinearDistance(double x, double y, double cellSize) {
   const double xi =
       std::floor(std::max(std::min(width(), x), 0.) / cellSize) * cellSize;
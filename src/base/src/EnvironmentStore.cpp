@@ -0,0 +1,116 @@
+#include "base/EnvironmentStore.h"
+
+#include <ompl/util/Console.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "base/PlannerSettings.h"
+#include "utils/ContentHash.hpp"
+
+namespace {
+const char *Directory = "environments";
+
+std::string base64(const std::vector<unsigned char> &data) {
+  static const char *alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve((data.size() + 2) / 3 * 4);
+  for (std::size_t i = 0; i < data.size(); i += 3) {
+    std::uint32_t chunk = (std::uint32_t)data[i] << 16;
+    if (i + 1 < data.size()) chunk |= (std::uint32_t)data[i + 1] << 8;
+    if (i + 2 < data.size()) chunk |= data[i + 2];
+    encoded += alphabet[(chunk >> 18) & 63];
+    encoded += alphabet[(chunk >> 12) & 63];
+    encoded += i + 1 < data.size() ? alphabet[(chunk >> 6) & 63] : '=';
+    encoded += i + 2 < data.size() ? alphabet[chunk & 63] : '=';
+  }
+  return encoded;
+}
+
+std::mutex store_mutex;
+// directories and hashes of the environments written by this process, since
+// the log file (and thereby the directory) may change between runs
+std::set<std::pair<std::string, std::uint64_t>> stored;
+}  // namespace
+
+std::uint16_t EnvironmentStore::toHalf(float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const auto sign = (std::uint16_t)((bits >> 16) & 0x8000u);
+  const std::uint32_t magnitude = bits & 0x7fffffffu;
+  // NaN and infinity
+  if (magnitude >= 0x7f800000u)
+    return sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u);
+  // overflow to infinity
+  if (magnitude >= 0x47800000u) return sign | 0x7c00u;
+  // subnormal numbers are multiples of 2^-24
+  if (magnitude < 0x38800000u)
+    return sign | (std::uint16_t)std::lround(std::fabs(value) * 16777216.f);
+  // rebias the exponent and round the mantissa to nearest even
+  std::uint32_t half = (magnitude - 0x38000000u) >> 13;
+  const std::uint32_t remainder = magnitude & 0x1fffu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+  return sign | (std::uint16_t)half;
+}
+
+nlohmann::json EnvironmentStore::store(const std::string &map,
+                                       unsigned int width,
+                                       unsigned int height,
+                                       const std::vector<double> &distances) {
+  std::vector<unsigned char> occupancy((map.size() + 7) / 8, 0);
+  for (std::size_t i = 0; i < map.size(); ++i) {
+    if (map[i] == '1') occupancy[i / 8] |= (unsigned char)(1u << (i % 8));
+  }
+  std::vector<unsigned char> halves;
+  halves.reserve(distances.size() * 2);
+  for (const double d : distances) {
+    const std::uint16_t h = toHalf((float)d);
+    halves.push_back((unsigned char)(h & 0xffu));
+    halves.push_back((unsigned char)(h >> 8));
+  }
+
+  const std::uint64_t hash = ContentHash()
+                                .add(width)
+                                .add(height)
+                                .add(occupancy.data(), occupancy.size())
+                                .add(halves.data(), halves.size())
+                                .value();
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  const std::string key = ss.str();
+  const std::string file = std::string(Directory) + "/" + key + ".json";
+  const nlohmann::json reference{{"hash", key}, {"file", file}};
+
+  const auto directory =
+      boost::filesystem::path(global::settings.benchmark.log_file.value())
+          .parent_path() /
+      Directory;
+  std::lock_guard<std::mutex> lock(store_mutex);
+  if (stored.count({directory.string(), hash}) > 0) return reference;
+  const auto filename = (directory / (key + ".json")).string();
+  if (!boost::filesystem::exists(filename)) {
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory, error);
+    nlohmann::json j{{"hash", key},
+                     {"width", width},
+                     {"height", height},
+                     {"map", base64(occupancy)}};
+    if (!distances.empty()) j["distances"] = base64(halves);
+    std::ofstream o(filename);
+    o << j;
+    if (!o.good()) {
+      OMPL_ERROR("Could not write environment to %s.", filename.c_str());
+      return nullptr;
+    }
+  }
+  stored.emplace(directory.string(), hash);
+  return reference;
+}
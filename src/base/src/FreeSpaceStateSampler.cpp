@@ -0,0 +1,110 @@
+#include "base/FreeSpaceStateSampler.h"
+
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/base/spaces/SE2StateSpace.h>
+#include <ompl/base/spaces/SO2StateSpace.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/environments/GridMaze.h"
+
+std::shared_ptr<FreeSpaceStateSampler::FreeCellIndex>
+FreeSpaceStateSampler::FreeCellIndex::build(GridMaze &grid,
+                                            bool clearance_weighted) {
+  auto index = std::make_shared<FreeCellIndex>();
+  index->voxels_x = grid.voxels_x();
+  index->width = grid.width();
+  index->height = grid.height();
+  double total = 0;
+  for (unsigned int i = 0; i < grid.cells(); ++i) {
+    if (grid.occupied(i)) continue;
+    index->cells.push_back(i);
+    if (clearance_weighted) {
+      total += 1. / std::max(1., grid.distance(i));
+      index->cumulative_weights.push_back(total);
+    }
+  }
+  return index;
+}
+
+bool FreeSpaceStateSampler::supports(const ob::StateSpace *space) {
+  if (dynamic_cast<const ob::SE2StateSpace *>(space) != nullptr) return true;
+  const auto *compound = dynamic_cast<const ob::CompoundStateSpace *>(space);
+  return compound != nullptr && compound->getSubspaceCount() >= 2 &&
+         compound->getSubspace(0)->getType() ==
+             ob::STATE_SPACE_REAL_VECTOR &&
+         compound->getSubspace(0)->getDimension() == 2 &&
+         compound->getSubspace(1)->getType() == ob::STATE_SPACE_SO2;
+}
+
+FreeSpaceStateSampler::FreeSpaceStateSampler(
+    const ob::StateSpace *space, std::shared_ptr<const FreeCellIndex> index,
+    bool low_discrepancy)
+    : ob::StateSampler(space),
+      index_(std::move(index)),
+      default_(space->allocDefaultStateSampler()),
+      se2_(dynamic_cast<const ob::SE2StateSpace *>(space) != nullptr) {
+  if (low_discrepancy) halton_ = std::make_shared<ob::HaltonSequence>(4);
+}
+
+void FreeSpaceStateSampler::setPose(ob::State *state, double x, double y,
+                                    double yaw) const {
+  if (se2_) {
+    auto *s = state->as<ob::SE2StateSpace::StateType>();
+    s->setXY(x, y);
+    s->setYaw(yaw);
+  } else {
+    auto *s = state->as<ob::CompoundState>();
+    auto *position = s->as<ob::RealVectorStateSpace::StateType>(0);
+    position->values[0] = x;
+    position->values[1] = y;
+    s->as<ob::SO2StateSpace::StateType>(1)->value = yaw;
+  }
+}
+
+void FreeSpaceStateSampler::sampleUniform(ob::State *state) {
+  // sample all remaining dimensions, position and heading are replaced below
+  default_->sampleUniform(state);
+  if (index_->cells.empty()) return;
+
+  double u[4];
+  if (halton_) {
+    const auto sample = halton_->sample();
+    std::copy(sample.begin(), sample.end(), u);
+  } else {
+    for (double &v : u) v = rng_.uniform01();
+  }
+
+  std::size_t i;
+  if (index_->cumulative_weights.empty()) {
+    i = std::min((std::size_t)(u[0] * index_->cells.size()),
+                 index_->cells.size() - 1);
+  } else {
+    const auto &weights = index_->cumulative_weights;
+    i = std::min(
+        (std::size_t)(std::upper_bound(weights.begin(), weights.end(),
+                                       u[0] * weights.back()) -
+                      weights.begin()),
+        weights.size() - 1);
+  }
+  const unsigned int cell = index_->cells[i];
+  // cell (cx, cy) covers [cx - .5, cx + .5] x [cy - .5, cy + .5]
+  const double x = cell % index_->voxels_x + u[1] - .5;
+  const double y = cell / index_->voxels_x + u[2] - .5;
+  setPose(state, std::max(0., std::min(x, index_->width)),
+          std::max(0., std::min(y, index_->height)),
+          -M_PI + 2. * M_PI * u[3]);
+}
+
+void FreeSpaceStateSampler::sampleUniformNear(ob::State *state,
+                                              const ob::State *near,
+                                              double distance) {
+  default_->sampleUniformNear(state, near, distance);
+}
+
+void FreeSpaceStateSampler::sampleGaussian(ob::State *state,
+                                           const ob::State *mean,
+                                           double stdDev) {
+  default_->sampleGaussian(state, mean, stdDev);
+}
@@ -0,0 +1,164 @@
+#include "base/HeuristicTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "base/Environment.h"
+#include "base/PlannerSettings.h"
+#include "base/environments/GridMaze.h"
+#include "utils/ContentHash.hpp"
+#include "utils/LruCache.hpp"
+
+namespace {
+constexpr float Unreachable = std::numeric_limits<float>::infinity();
+
+// 8-connected path lengths exceed Euclidean distances by at most
+// 1 / cos(pi / 8)
+const double OctileToEuclidean = std::cos(M_PI / 8.);
+
+struct CacheEntry {
+  std::uint64_t key;
+  std::shared_ptr<const HeuristicTable> table;
+};
+
+LruCache<CacheEntry> cache;
+
+/**
+ * Whether no point in the box [x0, x1] x [y0, y1] is free for a point robot.
+ * Grid mazes are checked by their cells, where cell (i, j) covers the
+ * coordinates that round to (i, j), without the footprint by which
+ * GridMaze::occupied(x, y) inflates them. Other environments are sampled at
+ * the corners, edge midpoints and center of the box.
+ */
+bool blocked(Environment &environment, double x0, double y0, double x1,
+             double y1) {
+  if (const auto *grid = dynamic_cast<const GridMaze *>(&environment)) {
+    const auto cell = [](double v, unsigned int cells) {
+      return (unsigned int)std::min<double>(cells - 1, std::max(0., v));
+    };
+    const unsigned int ix0 = cell(std::floor(x0 + .5), grid->voxels_x());
+    const unsigned int ix1 = cell(std::ceil(x1 - .5), grid->voxels_x());
+    const unsigned int iy0 = cell(std::floor(y0 + .5), grid->voxels_y());
+    const unsigned int iy1 = cell(std::ceil(y1 - .5), grid->voxels_y());
+    for (unsigned int iy = iy0; iy <= iy1; ++iy) {
+      for (unsigned int ix = ix0; ix <= ix1; ++ix) {
+        if (!grid->occupiedCell(ix, iy)) return false;
+      }
+    }
+    return true;
+  }
+  for (const double fy : {0., .5, 1.}) {
+    for (const double fx : {0., .5, 1.}) {
+      if (!environment.collides(x0 + fx * (x1 - x0), y0 + fy * (y1 - y0)))
+        return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+std::shared_ptr<const HeuristicTable> HeuristicTable::get(
+    Environment &environment, const Point &goal) {
+  const double resolution = global::settings.env.heuristic.resolution;
+  const std::uint64_t key = ContentHash()
+                                .add(environment.contentHash())
+                                .add(goal.x)
+                                .add(goal.y)
+                                .add(resolution)
+                                .value();
+  CacheEntry entry;
+  if (cache.find([key](const CacheEntry &e) { return e.key == key; }, entry))
+    return entry.table;
+
+  const auto &bounds = environment.bounds();
+  // the cells of grid mazes are centered at integer coordinates, to which
+  // the table is aligned, so that walls of a single cell are kept
+  const double offset =
+      dynamic_cast<const GridMaze *>(&environment) != nullptr ? .5 : 0.;
+  const double min_x = bounds.low[0] - offset, min_y = bounds.low[1] - offset;
+  const auto cells_x = (unsigned int)std::max(
+      1., std::ceil((bounds.high[0] - min_x) / resolution));
+  const auto cells_y = (unsigned int)std::max(
+      1., std::ceil((bounds.high[1] - min_y) / resolution));
+  std::vector<bool> occupied((std::size_t)cells_x * cells_y);
+  for (unsigned int y = 0; y < cells_y; ++y) {
+    for (unsigned int x = 0; x < cells_x; ++x) {
+      occupied[(std::size_t)y * cells_x + x] =
+          blocked(environment, min_x + x * resolution, min_y + y * resolution,
+                  min_x + (x + 1) * resolution, min_y + (y + 1) * resolution);
+    }
+  }
+
+  std::shared_ptr<const HeuristicTable> table(new HeuristicTable(
+      goal, min_x, min_y, resolution, cells_x, cells_y, occupied));
+  cache.insert({key, table}, global::settings.env.heuristic.cache_size.value(),
+               [key](const CacheEntry &e) { return e.key == key; });
+  return table;
+}
+
+HeuristicTable::HeuristicTable(const Point &goal, double min_x, double min_y,
+                               double resolution, unsigned int cells_x,
+                               unsigned int cells_y,
+                               const std::vector<bool> &occupied)
+    : costs_((std::size_t)cells_x * cells_y, Unreachable),
+      goal_(goal),
+      min_x_(min_x),
+      min_y_(min_y),
+      resolution_(resolution),
+      cells_x_(cells_x),
+      cells_y_(cells_y) {
+  const auto gx = (int)std::min<double>(
+      cells_x - 1, std::max(0., (goal.x - min_x) / resolution));
+  const auto gy = (int)std::min<double>(
+      cells_y - 1, std::max(0., (goal.y - min_y) / resolution));
+
+  typedef std::pair<float, std::size_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  const std::size_t goal_cell = (std::size_t)gy * cells_x + gx;
+  // the goal cell is expanded even if it is occupied
+  costs_[goal_cell] = 0;
+  open.emplace(0.f, goal_cell);
+  static const int dx[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+  static const int dy[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+  const auto step = (float)resolution;
+  const auto diagonal_step = (float)(std::sqrt(2.) * resolution);
+  while (!open.empty()) {
+    const auto [cost, cell] = open.top();
+    open.pop();
+    if (cost > costs_[cell]) continue;
+    const int x = (int)(cell % cells_x), y = (int)(cell / cells_x);
+    for (int i = 0; i < 8; ++i) {
+      const int nx = x + dx[i], ny = y + dy[i];
+      if (nx < 0 || ny < 0 || nx >= (int)cells_x || ny >= (int)cells_y)
+        continue;
+      const std::size_t next = (std::size_t)ny * cells_x + nx;
+      if (occupied[next]) continue;
+      const float next_cost = cost + (i < 4 ? step : diagonal_step);
+      if (next_cost < costs_[next]) {
+        costs_[next] = next_cost;
+        open.emplace(next_cost, next);
+      }
+    }
+  }
+}
+
+double HeuristicTable::costToGo(double x, double y) const {
+  const double euclidean = std::hypot(x - goal_.x, y - goal_.y);
+  const double cx = std::floor((x - min_x_) / resolution_);
+  const double cy = std::floor((y - min_y_) / resolution_);
+  if (cx < 0 || cy < 0 || cx >= cells_x_ || cy >= cells_y_) return euclidean;
+  const float cost = costs_[(std::size_t)cy * cells_x_ + (std::size_t)cx];
+  if (cost == Unreachable) return euclidean;
+  return std::max(euclidean, OctileToEuclidean * cost -
+                                 std::sqrt(2.) * resolution_);
+}
+
+double HeuristicTable::reachableRatio() const {
+  const auto reachable =
+      std::count_if(costs_.begin(), costs_.end(),
+                    [](float cost) { return cost != Unreachable; });
+  return (double)reachable / costs_.size();
+}
@@ -14,11 +14,18 @@
 
 #include <steering_functions/include/ompl_state_spaces/CurvatureStateSpace.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+#include "base/FreeSpaceStateSampler.h"
 #include "base/environments/GridMaze.h"
 #include "base/environments/PolygonMaze.h"
 #include "planners/OMPLControlPlanner.hpp"
 #include "planners/OMPLPlanner.hpp"
+#include "steer_functions/BatchDistance.h"
 #include "steer_functions/POSQ/POSQStateSpace.h"
+#include "steer_functions/SteerDistanceTable.h"
 
 #ifdef G1_AVAILABLE
 #include "steer_functions/G1Clothoid/ClothoidSteering.hpp"
@@ -43,28 +50,184 @@ ob::StateSamplerPtr allocateHaltonStateSampler(
         space, std::make_shared<ob::HaltonSequence>(space->getDimension()));
 }
 
+/**
+ * Path type computed by the steer function of the state space that can be
+ * reused for interpolation, or void if interpolation cannot be cached.
+ */
+template <typename StateSpaceT>
+struct SteerPathOf {
+  typedef void type;
+};
+template <>
+struct SteerPathOf<ob::ReedsSheppStateSpace> {
+  typedef ob::ReedsSheppStateSpace::ReedsSheppPath type;
+};
+template <>
+struct SteerPathOf<ob::DubinsStateSpace> {
+  typedef ob::DubinsStateSpace::DubinsPath type;
+};
+
 /**
  * Instrumented state space allows to measure time spent on computing the
  * steer function.
  */
 template <typename StateSpaceT>
-struct InstrumentedStateSpace : public StateSpaceT {
+struct InstrumentedStateSpace : public StateSpaceT, public BatchDistance {
   using StateSpaceT::StateSpaceT;
 
+  /**
+   * Optional table to look up distances of SE(2) states for the given turning
+   * radius in distanceMany(), which only ranks nearest neighbor candidates.
+   * Poses the table cannot interpolate use the exact distance.
+   */
+  std::shared_ptr<const SteerDistanceTable> distance_table{nullptr};
+  double distance_table_radius{1};
+
+  /**
+   * Exact length of the steer function's path, which is used for motion
+   * costs, path metrics and motion validation.
+   */
   double distance(const ob::State *state1,
                   const ob::State *state2) const override {
     global::settings.ompl.steering_timer.resume();
-    double d = StateSpaceT::distance(state1, state2);
+    const double d = StateSpaceT::distance(state1, state2);
     global::settings.ompl.steering_timer.stop();
     return d;
   }
 
+  /**
+   * Uses the SIMD batch kernels for the linear, Dubins and Reeds-Shepp steer
+   * functions, and computes the distances one by one for all other state
+   * spaces. Looks up the distances in the distance table if one is set.
+   */
+  void distanceMany(const ob::State *q, const ob::State *const *xs,
+                    double *out, std::size_t n) const override {
+    global::settings.ompl.steering_timer.resume();
+    if constexpr (std::is_same_v<StateSpaceT, ob::SE2StateSpace>) {
+      BatchDistance::se2(q, xs, out, n, this->getSubspaceWeight(0),
+                         this->getSubspaceWeight(1));
+    } else if constexpr (std::is_same_v<StateSpaceT, ob::DubinsStateSpace>) {
+      if (distance_table) {
+        distanceEach(q, xs, out, n);
+      } else {
+        BatchDistance::dubins(q, xs, out, n, this->rho_);
+      }
+    } else if constexpr (std::is_same_v<StateSpaceT,
+                                        ob::ReedsSheppStateSpace>) {
+      if (distance_table) {
+        distanceEach(q, xs, out, n);
+      } else {
+        BatchDistance::reedsShepp(q, xs, out, n, this->rho_);
+      }
+    } else {
+      distanceEach(q, xs, out, n);
+    }
+    global::settings.ompl.steering_timer.stop();
+  }
+
   void interpolate(const ob::State *from, const ob::State *to, double t,
                    ob::State *state) const override {
     global::settings.ompl.steering_timer.resume();
+    if constexpr (!std::is_void_v<SteerPath>) {
+      if (interpolation_cache_size > 0 && t > 0. && t < 1.) {
+        interpolateCached(from, to, t, state);
+        global::settings.ompl.steering_timer.stop();
+        return;
+      }
+    }
     StateSpaceT::interpolate(from, to, t, state);
     global::settings.ompl.steering_timer.stop();
   }
+
+  /**
+   * Number of most recently computed steer function paths to reuse for
+   * interpolation (only supported by the Reeds-Shepp and Dubins spaces),
+   * zero disables the cache. Every thread keeps its own paths, so lookups
+   * need no lock.
+   */
+  std::size_t interpolation_cache_size{0};
+
+ private:
+  typedef typename SteerPathOf<StateSpaceT>::type SteerPath;
+
+  struct CachedPath {
+    double from[3];
+    double to[3];
+    std::conditional_t<std::is_void_v<SteerPath>, bool, SteerPath> path;
+  };
+
+  /**
+   * Ring buffer of the most recently computed paths of one thread.
+   */
+  struct InterpolationCache {
+    // identifier of the state space the paths belong to
+    std::size_t owner{0};
+    std::vector<CachedPath> paths;
+    std::size_t next{0};
+  };
+
+  static void pose(const ob::State *state, double *out) {
+    const auto *s = state->as<ob::SE2StateSpace::StateType>();
+    out[0] = s->getX();
+    out[1] = s->getY();
+    out[2] = s->getYaw();
+  }
+
+  void interpolateCached(const ob::State *from, const ob::State *to, double t,
+                         ob::State *state) const {
+    thread_local InterpolationCache cache;
+    if (cache.owner != id_) {
+      cache.owner = id_;
+      cache.paths.clear();
+      cache.next = 0;
+    }
+
+    // read the key before state (which may alias from) is written
+    CachedPath entry;
+    pose(from, entry.from);
+    pose(to, entry.to);
+    bool hit = false;
+    for (const auto &cached : cache.paths) {
+      if (std::equal(entry.from, entry.from + 3, cached.from) &&
+          std::equal(entry.to, entry.to + 3, cached.to)) {
+        entry.path = cached.path;
+        hit = true;
+        break;
+      }
+    }
+    auto &counter = hit ? global::settings.ompl.interpolation_cache_hits
+                        : global::settings.ompl.interpolation_cache_misses;
+    counter.fetch_add(1, std::memory_order_relaxed);
+    bool first_time = !hit;
+    StateSpaceT::interpolate(from, to, t, first_time, entry.path, state);
+    if (hit) return;
+
+    if (cache.paths.size() < interpolation_cache_size) {
+      cache.paths.emplace_back(entry);
+    } else {
+      cache.paths[cache.next] = entry;
+      cache.next = (cache.next + 1) % cache.paths.size();
+    }
+  }
+
+  void distanceEach(const ob::State *q, const ob::State *const *xs,
+                    double *out, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      double d = -1;
+      if (distance_table)
+        d = distance_table->distance(q, xs[i], distance_table_radius);
+      out[i] = d < 0 ? StateSpaceT::distance(q, xs[i]) : d;
+    }
+  }
+
+  static std::size_t nextId() {
+    static std::atomic<std::size_t> instances{0};
+    return ++instances;
+  }
+
+  // identifies this state space in the thread-local interpolation caches,
+  // never reused by another instance
+  const std::size_t id_{nextId()};
 };
 
 void PlannerSettings::GlobalSettings::ForwardPropagationSettings::
@@ -183,23 +346,70 @@ void PlannerSettings::GlobalSettings::OmplSettings::initializeSampler() const {
           "Selected sampler not supported for selected steering function."
           " Using default sampler instead (i.i.d.).");
     }
+  } else if (global::settings.ompl.sampler.value().rfind("free_cells", 0) ==
+             0) {
+    const auto &sampler = global::settings.ompl.sampler.value();
+    const auto grid =
+        std::dynamic_pointer_cast<GridMaze>(global::settings.environment);
+    if (!grid) {
+      OMPL_ERROR(
+          "Sampler \"%s\" requires a grid environment. Using default sampler "
+          "instead (i.i.d.).",
+          sampler.c_str());
+      return;
+    }
+    if (!FreeSpaceStateSampler::supports(space_ptr.get())) {
+      OMPL_ERROR(
+          "Selected sampler not supported for selected steering function."
+          " Using default sampler instead (i.i.d.).");
+      return;
+    }
+    // the free cells are collected once per environment and shared by all
+    // samplers the planners allocate
+    const auto index = FreeSpaceStateSampler::FreeCellIndex::build(
+        *grid, sampler == "free_cells_clearance");
+    const bool low_discrepancy = sampler == "free_cells_halton";
+    space_ptr->setStateSamplerAllocator(
+        [index, low_discrepancy](
+            const ob::StateSpace *space) -> ob::StateSamplerPtr {
+          return std::make_shared<FreeSpaceStateSampler>(space, index,
+                                                         low_discrepancy);
+        });
   }
 }
 
+std::shared_ptr<const SteerDistanceTable>
+PlannerSettings::GlobalSettings::SteerSettings::loadDistanceTable() const {
+  if (!distance_table.enabled) return nullptr;
+  return SteerDistanceTable::loadOrGenerate(
+      steering_type, distance_table.extent, distance_table.cells_xy,
+      distance_table.cells_theta, distance_table.max_cell_spread,
+      distance_table.cache_dir);
+}
+
 void PlannerSettings::GlobalSettings::SteerSettings::initializeSteering()
     const {
   // Construct the robot state space in which we're planning.
-  if (steering_type == Steering::STEER_TYPE_REEDS_SHEPP)
-    global::settings.ompl.state_space =
-        ob::StateSpacePtr(new InstrumentedStateSpace<ob::ReedsSheppStateSpace>(
-            car_turning_radius));
-  else if (steering_type == Steering::STEER_TYPE_POSQ)
+  if (steering_type == Steering::STEER_TYPE_REEDS_SHEPP) {
+    auto *space = new InstrumentedStateSpace<ob::ReedsSheppStateSpace>(
+        car_turning_radius);
+    space->distance_table = loadDistanceTable();
+    space->distance_table_radius = car_turning_radius;
+    if (interpolation_cache.enabled)
+      space->interpolation_cache_size = interpolation_cache.size;
+    global::settings.ompl.state_space = ob::StateSpacePtr(space);
+  } else if (steering_type == Steering::STEER_TYPE_POSQ)
     global::settings.ompl.state_space =
         ob::StateSpacePtr(new InstrumentedStateSpace<POSQStateSpace>());
-  else if (steering_type == Steering::STEER_TYPE_DUBINS)
-    global::settings.ompl.state_space = ob::StateSpacePtr(
-        new InstrumentedStateSpace<ob::DubinsStateSpace>(car_turning_radius));
-  else if (steering_type == Steering::STEER_TYPE_LINEAR)
+  else if (steering_type == Steering::STEER_TYPE_DUBINS) {
+    auto *space =
+        new InstrumentedStateSpace<ob::DubinsStateSpace>(car_turning_radius);
+    space->distance_table = loadDistanceTable();
+    space->distance_table_radius = car_turning_radius;
+    if (interpolation_cache.enabled)
+      space->interpolation_cache_size = interpolation_cache.size;
+    global::settings.ompl.state_space = ob::StateSpacePtr(space);
+  } else if (steering_type == Steering::STEER_TYPE_LINEAR)
     global::settings.ompl.state_space =
         ob::StateSpacePtr(new InstrumentedStateSpace<ob::SE2StateSpace>);
   else if (steering_type == Steering::STEER_TYPE_CC_DUBINS)
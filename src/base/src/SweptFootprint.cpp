@@ -0,0 +1,75 @@
+#include "base/SweptFootprint.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/PlannerSettings.h"
+
+SweptFootprint::SweptFootprint(const Polygon &shape, double curvature)
+    : shape_(shape), curvature_(curvature) {
+  for (const auto &p : shape_.points)
+    radius_ = std::max(radius_, std::sqrt(p.x * p.x + p.y * p.y));
+}
+
+double SweptFootprint::steerCurvature() {
+  switch (global::settings.steer.steering_type) {
+    case Steering::STEER_TYPE_REEDS_SHEPP:
+    case Steering::STEER_TYPE_DUBINS:
+      return 1. / global::settings.steer.car_turning_radius;
+    case Steering::STEER_TYPE_CC_DUBINS:
+    case Steering::STEER_TYPE_CC_REEDS_SHEPP:
+    case Steering::STEER_TYPE_HC_REEDS_SHEPP:
+      return global::settings.steer.hc_cc.kappa;
+    default:
+      return 0;
+  }
+}
+
+double SweptFootprint::margin(const ompl::base::State *a,
+                              const ompl::base::State *b,
+                              double arc_length) const {
+  const auto *sa = a->as<State>();
+  const auto *sb = b->as<State>();
+  const double chord =
+      std::hypot(sb->getX() - sa->getX(), sb->getY() - sa->getY());
+  // headings are normalized to [-pi, pi)
+  double rotation = std::abs(sb->getYaw() - sa->getYaw());
+  if (rotation > M_PI) rotation = 2. * M_PI - rotation;
+
+  // arc length of the reference point and total rotation along the motion
+  double arc = chord, turn = rotation;
+  if (curvature_ > 0) {
+    arc = std::max(chord, arc_length);
+    turn = std::max(rotation, arc * curvature_);
+  }
+  const double travel = arc + radius_ * turn;
+  const double min_chord =
+      std::max(0., chord - 2. * radius_ * std::sin(rotation / 2.));
+  return .5 * std::sqrt(std::max(0., travel * travel - min_chord * min_chord));
+}
+
+Polygon SweptFootprint::hull(const ompl::base::State *a,
+                             const ompl::base::State *b,
+                             double arc_length) const {
+  const double m = margin(a, b, arc_length);
+  Polygon placements;
+  placements.points.reserve(shape_.points.size() * (m > 0 ? 8 : 2));
+  for (const auto *state : {a, b}) {
+    const auto *s = state->as<State>();
+    const double c = std::cos(s->getYaw()), sn = std::sin(s->getYaw());
+    for (const auto &p : shape_.points) {
+      const Point q(s->getX() + p.x * c - p.y * sn,
+                    s->getY() + p.x * sn + p.y * c);
+      if (m > 0) {
+        // the square around each point contains the disk of the margin
+        placements.points.emplace_back(q.x - m, q.y - m);
+        placements.points.emplace_back(q.x + m, q.y - m);
+        placements.points.emplace_back(q.x + m, q.y + m);
+        placements.points.emplace_back(q.x - m, q.y + m);
+      } else {
+        placements.points.emplace_back(q);
+      }
+    }
+  }
+  return placements.convexHull();
+}
@@ -0,0 +1,191 @@
+#ifndef _BATCH_DIRECTED_CONTROL_SAMPLER_
+#define _BATCH_DIRECTED_CONTROL_SAMPLER_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ompl/control/DirectedControlSampler.h>
+#include <ompl/control/SpaceInformation.h>
+#include <ompl/control/spaces/RealVectorControlSpace.h>
+
+#include "base/PlannerSettings.h"
+#include "fp_models/ForwardPropagation.h"
+#include "fp_models/Integration.hpp"
+#include "fp_models/kinematic_car/kinematic_car.hpp"
+#include "fp_models/kinematic_single_track/kinematic_single_track.hpp"
+
+namespace oc = ompl::control;
+namespace ob = ompl::base;
+
+namespace ForwardPropagation {
+/**
+ * Directed control sampler that samples several controls and durations from
+ * the source state, propagates them together in structure-of-arrays layout
+ * with the batched propagate functions of the kinematic models, and returns
+ * the control whose last valid state is closest to the target, as
+ * oc::SimpleDirectedControlSampler does with multiple control samples.
+ *
+ * All controls advance in lockstep by one propagation step at a time; a
+ * control drops out of the batch once it reaches its sampled duration or
+ * its next state is invalid. The resulting states are written to states that
+ * are allocated once per sampler.
+ */
+class BatchDirectedControlSampler : public oc::DirectedControlSampler {
+ public:
+  BatchDirectedControlSampler(const oc::SpaceInformation *si,
+                              unsigned int num_control_samples)
+      : oc::DirectedControlSampler(si),
+        control_sampler_(si->allocControlSampler()),
+        size_(std::min<std::size_t>(std::max(1u, num_control_samples),
+                                    MaxBatchSize)),
+        single_track_(
+            global::settings.forwardpropagation.forward_propagation_type ==
+            FORWARD_PROPAGATION_TYPE_KINEMATIC_SINGLE_TRACK) {
+    for (std::size_t i = 0; i < size_; ++i) {
+      controls_[i] = si_->allocControl();
+      states_[i] = si_->allocState();
+    }
+    scratch_ = si_->allocState();
+  }
+
+  ~BatchDirectedControlSampler() override {
+    for (std::size_t i = 0; i < size_; ++i) {
+      si_->freeControl(controls_[i]);
+      si_->freeState(states_[i]);
+    }
+    si_->freeState(scratch_);
+  }
+
+  unsigned int sampleTo(oc::Control *control, const ob::State *source,
+                        ob::State *dest) override {
+    return sampleBest(control, nullptr, source, dest);
+  }
+
+  unsigned int sampleTo(oc::Control *control, const oc::Control *previous,
+                        const ob::State *source, ob::State *dest) override {
+    return sampleBest(control, previous, source, dest);
+  }
+
+ protected:
+  unsigned int sampleBest(oc::Control *control, const oc::Control *previous,
+                          const ob::State *source, ob::State *dest) {
+    const unsigned int min_steps = si_->getMinControlDuration();
+    const unsigned int max_steps = si_->getMaxControlDuration();
+    unsigned int steps[MaxBatchSize], valid_steps[MaxBatchSize];
+    bool active[MaxBatchSize];
+    unsigned int longest = 0;
+    std::size_t remaining = 0;
+    for (std::size_t i = 0; i < size_; ++i) {
+      if (previous != nullptr)
+        control_sampler_->sampleNext(controls_[i], previous, source);
+      else
+        control_sampler_->sample(controls_[i], source);
+      const double *u =
+          controls_[i]->as<oc::RealVectorControlSpace::ControlType>()->values;
+      u0_[i] = u[0];
+      u1_[i] = u[1];
+      steps[i] = control_sampler_->sampleStepCount(min_steps, max_steps);
+      valid_steps[i] = 0;
+      active[i] = steps[i] > 0;
+      remaining += active[i];
+      longest = std::max(longest, steps[i]);
+      si_->copyState(states_[i], source);
+      load(source, i);
+    }
+
+    const double step_size = si_->getPropagationStepSize();
+    const auto integration_steps = (unsigned int)std::max(
+        1., std::ceil(step_size / global::settings.forwardpropagation.dt));
+    double *const q[5] = {lanes_[0], lanes_[1], lanes_[2], lanes_[3],
+                          lanes_[4]};
+    for (unsigned int step = 1; step <= longest && remaining > 0; ++step) {
+      global::settings.ompl.steering_timer.resume();
+      if (single_track_)
+        kinematicSingleTrack::propagateMany(q, u0_, u1_, size_, step_size,
+                                            integration_steps);
+      else
+        KinematicCar::propagateMany(q[0], q[1], q[2], u0_, u1_, size_,
+                                    step_size);
+      global::settings.ompl.steering_timer.stop();
+
+      for (std::size_t i = 0; i < size_; ++i) {
+        if (!active[i]) continue;
+        store(i, scratch_);
+        if (si_->isValid(scratch_)) {
+          std::swap(scratch_, states_[i]);
+          valid_steps[i] = step;
+          active[i] = step < steps[i];
+        } else {
+          active[i] = false;
+        }
+        remaining -= !active[i];
+      }
+    }
+
+    std::size_t best = 0;
+    double best_distance = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < size_; ++i) {
+      const double d = si_->distance(states_[i], dest);
+      if (d < best_distance) {
+        best_distance = d;
+        best = i;
+      }
+    }
+    si_->copyControl(control, controls_[best]);
+    si_->copyState(dest, states_[best]);
+    return valid_steps[best];
+  }
+
+  const ob::SE2StateSpace::StateType *se2(const ob::State *state) const {
+    if (!single_track_) return state->as<ob::SE2StateSpace::StateType>();
+    return state->as<ob::CompoundStateSpace::StateType>()
+        ->as<ob::SE2StateSpace::StateType>(0);
+  }
+
+  ob::SE2StateSpace::StateType *se2(ob::State *state) const {
+    if (!single_track_) return state->as<ob::SE2StateSpace::StateType>();
+    return state->as<ob::CompoundStateSpace::StateType>()
+        ->as<ob::SE2StateSpace::StateType>(0);
+  }
+
+  void load(const ob::State *state, std::size_t i) {
+    const auto *s = se2(state);
+    lanes_[0][i] = s->getX();
+    lanes_[1][i] = s->getY();
+    lanes_[2][i] = s->getYaw();
+    if (single_track_) {
+      const auto *real = state->as<ob::CompoundStateSpace::StateType>()
+                             ->as<ob::RealVectorStateSpace::StateType>(1);
+      lanes_[3][i] = real->values[0];
+      lanes_[4][i] = real->values[1];
+    }
+  }
+
+  void store(std::size_t i, ob::State *state) const {
+    auto *s = se2(state);
+    s->setXY(lanes_[0][i], lanes_[1][i]);
+    s->setYaw(normalizeYaw(lanes_[2][i]));
+    if (single_track_) {
+      auto *real = state->as<ob::CompoundStateSpace::StateType>()
+                       ->as<ob::RealVectorStateSpace::StateType>(1);
+      real->values[0] = lanes_[3][i];
+      real->values[1] = lanes_[4][i];
+    }
+  }
+
+  oc::ControlSamplerPtr control_sampler_;
+  std::size_t size_;
+  bool single_track_;
+
+  oc::Control *controls_[MaxBatchSize];
+  ob::State *states_[MaxBatchSize];
+  ob::State *scratch_{nullptr};
+
+  // [x, y, heading, v_long, steering_angle] of each control
+  double lanes_[5][MaxBatchSize];
+  double u0_[MaxBatchSize], u1_[MaxBatchSize];
+};
+}  // namespace ForwardPropagation
+
+#endif /* _BATCH_DIRECTED_CONTROL_SAMPLER_ */
@@ -0,0 +1,61 @@
+#ifndef _FP_INTEGRATION_
+#define _FP_INTEGRATION_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace ForwardPropagation {
+/**
+ * Maximum number of controls that are propagated together by the batched
+ * propagate functions of the models.
+ */
+constexpr std::size_t MaxBatchSize = 64;
+
+/**
+ * Normalizes the heading to [-pi, pi) like SO2StateSpace::enforceBounds(),
+ * without constructing a state space.
+ */
+inline double normalizeYaw(double yaw) {
+  yaw = std::fmod(yaw, 2. * M_PI);
+  if (yaw < -M_PI)
+    yaw += 2. * M_PI;
+  else if (yaw >= M_PI)
+    yaw -= 2. * M_PI;
+  return yaw;
+}
+
+/**
+ * Classical fourth-order Runge-Kutta integration with a fixed number of
+ * equally sized steps. The state and all stages live in fixed-size arrays,
+ * so the integration does not allocate.
+ *
+ * The model defines `Dimension` and a call operator
+ * `void operator()(const Vector &q, Vector &qdot) const` that evaluates the
+ * derivative of the state q for constant controls.
+ */
+template <class Model>
+inline void rungeKutta4(const Model &model,
+                        std::array<double, Model::Dimension> &q,
+                        double duration, unsigned int steps) {
+  typedef std::array<double, Model::Dimension> Vector;
+  const double h = duration / steps;
+  Vector k1, k2, k3, k4, tmp;
+  for (unsigned int step = 0; step < steps; ++step) {
+    model(q, k1);
+    for (std::size_t i = 0; i < Model::Dimension; ++i)
+      tmp[i] = q[i] + .5 * h * k1[i];
+    model(tmp, k2);
+    for (std::size_t i = 0; i < Model::Dimension; ++i)
+      tmp[i] = q[i] + .5 * h * k2[i];
+    model(tmp, k3);
+    for (std::size_t i = 0; i < Model::Dimension; ++i)
+      tmp[i] = q[i] + h * k3[i];
+    model(tmp, k4);
+    for (std::size_t i = 0; i < Model::Dimension; ++i)
+      q[i] += h / 6. * (k1[i] + 2. * (k2[i] + k3[i]) + k4[i]);
+  }
+}
+}  // namespace ForwardPropagation
+
+#endif /* _FP_INTEGRATION_ */
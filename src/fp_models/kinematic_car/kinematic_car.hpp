@@ -1,11 +1,15 @@
 #ifndef _KINEMATIC_CAR_
 #define _KINEMATIC_CAR_
 
+#include <cmath>
+
 #include <ompl/base/spaces/SE2StateSpace.h>
 #include <ompl/control/ODESolver.h>
 #include <ompl/control/SpaceInformation.h>
 #include <ompl/control/spaces/RealVectorControlSpace.h>
 
+#include "fp_models/Integration.hpp"
+
 namespace oc = ompl::control;
 namespace ob = ompl::base;
 
@@ -38,37 +42,65 @@ inline void kinematicCarPostIntegration(const ob::State* /*state*/,
                         ->as<ob::SO2StateSpace::StateType>(1));
 }
 
-inline void propagate(const oc::SpaceInformation* si, const ob::State* state,
-               const oc::Control* control, const double duration,
-               ob::State* result) {
+/**
+ * Moves the pose (x, y, yaw) for the given duration at constant velocity and
+ * yaw rate, i.e. along a circular arc or a straight line. The displacement is
+ * the chord of the arc, which avoids the division by the yaw rate.
+ */
+inline void integrateArc(double &x, double &y, double &yaw, double velocity,
+                         double yaw_rate, double duration) {
+  const double half_turn = .5 * yaw_rate * duration;
+  double chord = velocity * duration;
+  if (std::abs(half_turn) > 1e-9) chord *= std::sin(half_turn) / half_turn;
+  x += chord * std::cos(yaw + half_turn);
+  y += chord * std::sin(yaw + half_turn);
+  yaw += 2. * half_turn;
+}
+
+/**
+ * Exact propagation of the kinematic car (see kinematicCarODE()), whose
+ * controls u = [velocity, steering_angle] are constant over the duration.
+ * The result is not checked against the state bounds here, the validity
+ * checker rejects it once per propagated segment instead.
+ */
+inline void propagate(const oc::SpaceInformation* /*si*/,
+                      const ob::State* state, const oc::Control* control,
+                      const double duration, ob::State* result) {
   global::settings.ompl.steering_timer.resume();
-  static double timeStep = global::settings.forwardpropagation.dt;
-  int nsteps = ceil(duration / timeStep);
-  double dt = duration / nsteps;
   const double* u =
       control->as<oc::RealVectorControlSpace::ControlType>()->values;
+  const auto* from = state->as<ob::SE2StateSpace::StateType>();
+  auto* se2 = result->as<ob::SE2StateSpace::StateType>();
 
-  ob::SE2StateSpace::StateType& se2 =
-      *result->as<ob::SE2StateSpace::StateType>();
-
-  si->getStateSpace()->copyState(result, state);
-
-  for (int i = 0; i < nsteps; i++) {
-    se2.setX(se2.getX() + dt * u[0] * cos(se2.getYaw()));
-    se2.setY(se2.getY() + dt * u[0] * sin(se2.getYaw()));
-    se2.setYaw(se2.getYaw() +
-               dt * u[0] * tan(dt * u[1]) /
-                   global::settings.forwardpropagation.car_length);
+  double x = from->getX(), y = from->getY(), yaw = from->getYaw();
+  integrateArc(x, y, yaw, u[0],
+               u[0] * std::tan(u[1]) /
+                   global::settings.forwardpropagation.car_length,
+               duration);
+  se2->setXY(x, y);
+  se2->setYaw(ForwardPropagation::normalizeYaw(yaw));
+  global::settings.ompl.steering_timer.stop();
+}
 
-    if (!si->satisfiesBounds(result)) {
-      global::settings.ompl.steering_timer.stop();
-      return;
-    }
+/**
+ * Propagates n poses in structure-of-arrays layout, each with its own
+ * constant controls, for the same duration (see propagate()). Headings are
+ * not normalized.
+ */
+inline void propagateMany(double* x, double* y, double* yaw,
+                          const double* velocity, const double* steering,
+                          std::size_t n, double duration) {
+  const double inv_car_length =
+      1. / global::settings.forwardpropagation.car_length;
+  for (std::size_t i = 0; i < n; ++i) {
+    const double half_turn =
+        .5 * velocity[i] * std::tan(steering[i]) * inv_car_length * duration;
+    double chord = velocity[i] * duration;
+    if (std::abs(half_turn) > 1e-9) chord *= std::sin(half_turn) / half_turn;
+    x[i] += chord * std::cos(yaw[i] + half_turn);
+    y[i] += chord * std::sin(yaw[i] + half_turn);
+    yaw[i] += 2. * half_turn;
   }
-
-  ob::SO2StateSpace SO2;
-  SO2.enforceBounds(se2.as<ob::SO2StateSpace::StateType>(1));
-  global::settings.ompl.steering_timer.stop();
 }
 
 }  // namespace KinematicCar
@@ -1,11 +1,18 @@
 #ifndef _KINEMATIC_SINGLE_TRACK_
 #define _KINEMATIC_SINGLE_TRACK_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <ompl/base/spaces/RealVectorStateSpace.h>
 #include <ompl/base/spaces/SE2StateSpace.h>
 #include <ompl/control/ODESolver.h>
 #include <ompl/control/SpaceInformation.h>
 #include <ompl/control/spaces/RealVectorControlSpace.h>
 
+#include "fp_models/Integration.hpp"
+
 namespace oc = ompl::control;
 namespace ob = ompl::base;
 
@@ -44,44 +51,112 @@ inline void kinematicSingleTrackPostIntegration(const ob::State* state,
   SO2.enforceBounds(se2state->as<ob::SO2StateSpace::StateType>(1));
 }
 
-inline void propagate(const oc::SpaceInformation* si, const ob::State* state,
-               const oc::Control* control, const double duration,
-               ob::State* result) {
-  global::settings.ompl.steering_timer.resume();
-  static double timeStep = global::settings.forwardpropagation.dt;
-  int nsteps = ceil(duration / timeStep);
+/**
+ * Right-hand side of kinematicSingleTrackODE() for constant controls, used
+ * with ForwardPropagation::rungeKutta4().
+ */
+struct Dynamics {
+  static constexpr std::size_t Dimension = 5;
 
-  double dt = duration / nsteps;
+  double inv_car_length;
+  double long_acc;
+  double steering_rate;
+
+  // q = [x, y, heading, v_long, steering_angle]
+  void operator()(const std::array<double, Dimension>& q,
+                  std::array<double, Dimension>& qdot) const {
+    qdot[0] = q[3] * std::cos(q[2]);
+    qdot[1] = q[3] * std::sin(q[2]);
+    qdot[2] = q[3] * inv_car_length * std::tan(q[4]);
+    qdot[3] = long_acc;
+    qdot[4] = steering_rate;
+  }
+};
+
+/**
+ * Propagates the kinematic single-track model with fixed-size RK4 steps of at
+ * most forwardpropagation.dt. The result is not checked against the state
+ * bounds here, the validity checker rejects it once per propagated segment
+ * instead.
+ */
+inline void propagate(const oc::SpaceInformation* /*si*/,
+                      const ob::State* state, const oc::Control* control,
+                      const double duration, ob::State* result) {
+  global::settings.ompl.steering_timer.resume();
   const double* u =
       control->as<oc::RealVectorControlSpace::ControlType>()->values;
+  const auto* from = state->as<ob::CompoundStateSpace::StateType>();
+  const auto* from_se2 = from->as<ob::SE2StateSpace::StateType>(0);
+  const auto* from_real = from->as<ob::RealVectorStateSpace::StateType>(1);
 
-  ob::CompoundStateSpace::StateType& s =
-      *result->as<ob::CompoundStateSpace::StateType>();
-  ob::SE2StateSpace::StateType& se2 = *s.as<ob::SE2StateSpace::StateType>(0);
-  ob::RealVectorStateSpace::StateType& realPart =
-      *s.as<ob::RealVectorStateSpace::StateType>(1);
-
-  si->getStateSpace()->copyState(result, state);
-
-  for (int i = 0; i < nsteps; i++) {
-    se2.setX(se2.getX() + dt * realPart.values[0] * cos(se2.getYaw()));
-    se2.setY(se2.getY() + dt * realPart.values[0] * sin(se2.getYaw()));
-    se2.setYaw(se2.getYaw() +
-               dt * realPart.values[0] * tan(realPart.values[1]) /
-                   global::settings.forwardpropagation.car_length);
-    realPart.values[0] = realPart.values[0] + dt * u[0];
-    realPart.values[1] = realPart.values[1] + dt * u[1];
-
-    if (!si->satisfiesBounds(result)) {
-      global::settings.ompl.steering_timer.stop();
-      return;
-    }
-  }
+  std::array<double, Dynamics::Dimension> q{
+      from_se2->getX(), from_se2->getY(), from_se2->getYaw(),
+      from_real->values[0], from_real->values[1]};
+  const Dynamics dynamics{1. / global::settings.forwardpropagation.car_length,
+                          u[0], u[1]};
+  const double dt = global::settings.forwardpropagation.dt;
+  const auto steps =
+      (unsigned int)std::max(1., std::ceil(std::abs(duration) / dt));
+  ForwardPropagation::rungeKutta4(dynamics, q, duration, steps);
 
-  ob::SO2StateSpace SO2;
-  SO2.enforceBounds(se2.as<ob::SO2StateSpace::StateType>(1));
+  auto* s = result->as<ob::CompoundStateSpace::StateType>();
+  auto* se2 = s->as<ob::SE2StateSpace::StateType>(0);
+  auto* real = s->as<ob::RealVectorStateSpace::StateType>(1);
+  se2->setXY(q[0], q[1]);
+  se2->setYaw(ForwardPropagation::normalizeYaw(q[2]));
+  real->values[0] = q[3];
+  real->values[1] = q[4];
   global::settings.ompl.steering_timer.stop();
 }
 
+/**
+ * Propagates n states in structure-of-arrays layout (q[d][i] is dimension d
+ * of state i), each with its own constant controls, for the same duration
+ * using the given number of RK4 steps (see propagate()). At most
+ * ForwardPropagation::MaxBatchSize states are supported. Headings are not
+ * normalized.
+ */
+inline void propagateMany(double* const q[Dynamics::Dimension],
+                          const double* long_acc, const double* steering_rate,
+                          std::size_t n, double duration, unsigned int steps) {
+  constexpr std::size_t D = Dynamics::Dimension;
+  constexpr std::size_t N = ForwardPropagation::MaxBatchSize;
+  const double inv_car_length =
+      1. / global::settings.forwardpropagation.car_length;
+  const double h = duration / steps;
+  double k[4][D][N], stage[D][N];
+
+  const auto derivative = [&](const double* const* s, double(*qdot)[N]) {
+    for (std::size_t i = 0; i < n; ++i) {
+      qdot[0][i] = s[3][i] * std::cos(s[2][i]);
+      qdot[1][i] = s[3][i] * std::sin(s[2][i]);
+      qdot[2][i] = s[3][i] * inv_car_length * std::tan(s[4][i]);
+      qdot[3][i] = long_acc[i];
+      qdot[4][i] = steering_rate[i];
+    }
+  };
+  const double* stage_rows[D];
+  for (std::size_t d = 0; d < D; ++d) stage_rows[d] = stage[d];
+  const auto advance = [&](const double(*slope)[N], double factor) {
+    for (std::size_t d = 0; d < D; ++d)
+      for (std::size_t i = 0; i < n; ++i)
+        stage[d][i] = q[d][i] + factor * h * slope[d][i];
+  };
+
+  for (unsigned int step = 0; step < steps; ++step) {
+    derivative(q, k[0]);
+    advance(k[0], .5);
+    derivative(stage_rows, k[1]);
+    advance(k[1], .5);
+    derivative(stage_rows, k[2]);
+    advance(k[2], 1.);
+    derivative(stage_rows, k[3]);
+    for (std::size_t d = 0; d < D; ++d)
+      for (std::size_t i = 0; i < n; ++i)
+        q[d][i] += h / 6. *
+                   (k[0][d][i] + 2. * (k[1][d][i] + k[2][d][i]) + k[3][d][i]);
+  }
+}
+
 }  // namespace kinematicSingleTrack
 #endif /* _KINEMATIC_SINGLE_TRACK_ */
\ No newline at end of file
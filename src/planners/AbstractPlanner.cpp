@@ -1,5 +1,7 @@
 #include "AbstractPlanner.h"
 
+#include "base/BisectionMotionValidator.h"
+#include "base/ClearanceMotionValidator.h"
 #include "base/EnvironmentStateValidityChecker.h"
 
 std::string AbstractPlanner::LastCreatedPlannerName = "";
@@ -33,11 +35,14 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
 
   if (control_based_) {
     ss_c = new oc::SimpleSetup(global::settings.ompl.control_space);
+    // the state propagators do not check the bounds of their results
+    const auto *si = ss_c->getSpaceInformation().get();
 
     if (global::settings.env.collision.collision_model == robot::ROBOT_POINT) {
       if (global::settings.forwardpropagation.forward_propagation_type ==
           ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_CAR) {
-        ss_c->setStateValidityChecker([&](const ob::State *state) -> bool {
+        ss_c->setStateValidityChecker([si](const ob::State *state) -> bool {
+          if (!si->satisfiesBounds(state)) return false;
           const auto *s = state->as<ob::SE2StateSpace::StateType>();
           const double x = s->getX(), y = s->getY();
           return !global::settings.environment->collides(x, y);
@@ -46,7 +51,8 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
 
       if (global::settings.forwardpropagation.forward_propagation_type ==
           ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_SINGLE_TRACK) {
-        ss_c->setStateValidityChecker([&](const ob::State *state) -> bool {
+        ss_c->setStateValidityChecker([si](const ob::State *state) -> bool {
+          if (!si->satisfiesBounds(state)) return false;
           const auto *compState =
               state->as<ob::CompoundStateSpace::StateType>();
           const auto *se2state = compState->as<ob::SE2StateSpace::StateType>(0);
@@ -58,23 +64,22 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
     } else {
       if (global::settings.forwardpropagation.forward_propagation_type ==
           ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_CAR) {
-        ss_c->setStateValidityChecker([&](const ob::State *state) -> bool {
-          return !global::settings.environment->collides(
-              global::settings.env.collision.robot_shape.value().transformed(
-                  state));
+        ss_c->setStateValidityChecker([si](const ob::State *state) -> bool {
+          if (!si->satisfiesBounds(state)) return false;
+          return !global::settings.environment->collidesFootprint(state);
         });
       }
 
       if (global::settings.forwardpropagation.forward_propagation_type ==
           ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_SINGLE_TRACK) {
-        ss_c->setStateValidityChecker([&](const ob::State *state) -> bool {
+        ss_c->setStateValidityChecker([si](const ob::State *state) -> bool {
+          if (!si->satisfiesBounds(state)) return false;
           const auto *compState =
               state->as<ob::CompoundStateSpace::StateType>();
           const ob::State *se2state =
               compState->as<ob::SE2StateSpace::StateType>(0);
-          bool coll = global::settings.environment->collides(
-              global::settings.env.collision.robot_shape.value().transformed(
-                  se2state));
+          bool coll =
+              global::settings.environment->collidesFootprint(se2state);
           return !coll;
         });
       }
@@ -106,6 +111,15 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
       // which causes problems in Clothoid steering
     }
 #endif
+    else if (global::settings.env.collision.adaptive_motion_validation &&
+             ClearanceMotionValidator::supportsSteering()) {
+      si->setMotionValidator(std::make_shared<ClearanceMotionValidator>(
+          si, global::settings.environment));
+    } else if (global::settings.env.collision.bisection_motion_validation &&
+               BisectionMotionValidator::supportsSteering()) {
+      si->setMotionValidator(std::make_shared<BisectionMotionValidator>(
+          si, global::settings.environment));
+    }
 
     si->setStateValidityCheckingResolution(
         global::settings.steer.sampling_resolution);
@@ -115,13 +129,35 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
         global::settings.steer.sampling_resolution);
   }
 
-  const auto start = global::settings.environment->startScopedState();
-  const auto goal = global::settings.environment->goalScopedState();
-
   if (control_based_) {
     ss_c->getSpaceInformation()->setMinMaxControlDuration(1, 1);
     ss_c->setOptimizationObjective(global::settings.ompl.objective);
+  } else {
+    ss->setOptimizationObjective(global::settings.ompl.objective);
+  }
+  setStartAndGoalStates(*global::settings.environment);
+  if (!control_based_) ss->setup();
+}
 
+bool AbstractPlanner::reset(Environment &environment) {
+  if (control_based_ ? ss_c == nullptr : ss == nullptr) return false;
+  intermediarySolutions.clear();
+  intermediaryControlSolutions.clear();
+  roadmapStatistics = RoadmapStatistics();
+  // clears the planner's data structures and previous solutions
+  if (control_based_)
+    ss_c->clear();
+  else
+    ss->clear();
+  setStartAndGoalStates(environment);
+  return true;
+}
+
+void AbstractPlanner::setStartAndGoalStates(Environment &environment) {
+  const auto start = environment.startScopedState();
+  const auto goal = environment.goalScopedState();
+
+  if (control_based_) {
     // KinematicCar is SO3
     if (global::settings.forwardpropagation.forward_propagation_type ==
         ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_CAR) {
@@ -141,9 +177,7 @@ AbstractPlanner::AbstractPlanner(const std::string &name) {
     }
 
   } else {
-    ss->setOptimizationObjective(global::settings.ompl.objective);
     ss->setStartAndGoalStates(start, goal, global::settings.exact_goal_radius);
-    ss->setup();
   }
 
   std::cout << "Start: " << std::endl << start << std::endl;
@@ -26,6 +26,8 @@ namespace ob = ompl::base;
 namespace og = ompl::geometric;
 namespace oc = ompl::control;
 
+class Environment;
+
 class AbstractPlanner {
  public:
   virtual std::string name() const = 0;
@@ -39,6 +41,15 @@ class AbstractPlanner {
 
   virtual ob::PlannerStatus run() = 0;
 
+  /**
+   * Prepares the planner for another run in the given environment by
+   * clearing its data structures and updating start and goal, while keeping
+   * its configuration, allocated structures and setup.
+   * Returns false if the planner cannot be reused and needs to be
+   * reconstructed.
+   */
+  virtual bool reset(Environment &environment);
+
   virtual std::vector<Point> solutionPath() const {
     auto path = solution();
     return Point::fromPath(path);
@@ -47,6 +58,12 @@ class AbstractPlanner {
   struct IntermediarySolution {
     double time{std::numeric_limits<double>::quiet_NaN()};
     double cost{std::numeric_limits<double>::quiet_NaN()};
+    /**
+     * Collision checking and steering time spent by the planner until the
+     * solution was recorded (only set for checkpoint solutions).
+     */
+    double collision_time{std::numeric_limits<double>::quiet_NaN()};
+    double steering_time{std::numeric_limits<double>::quiet_NaN()};
     og::PathGeometric solution;
     IntermediarySolution(double time, double cost,
                          const og::PathGeometric &solution)
@@ -66,6 +83,32 @@ class AbstractPlanner {
 
   std::vector<IntermediaryControlSolution> intermediaryControlSolutions;
 
+  /**
+   * Times (in seconds after the start of run()) at which planners that
+   * support checkpoints record the best solution found so far in
+   * checkpointSolutions. Checkpoints reached after the planner has stopped
+   * record its final solution.
+   */
+  std::vector<double> checkpoints;
+  std::vector<IntermediarySolution> checkpointSolutions;
+
+  virtual bool supportsCheckpoints() const { return false; }
+
+  /**
+   * Timings of multi-query planners whose roadmap is kept between runs (see
+   * RoadmapCache). The query time is only measured for runs that reuse an
+   * existing roadmap, the run constructing it reports its planning time as
+   * construction time.
+   */
+  struct RoadmapStatistics {
+    bool reused{false};
+    double construction_time{std::numeric_limits<double>::quiet_NaN()};
+    double load_time{std::numeric_limits<double>::quiet_NaN()};
+    double query_time{std::numeric_limits<double>::quiet_NaN()};
+  };
+
+  RoadmapStatistics roadmapStatistics;
+
   /**
    * Returns the solution of the planner, which is a sparse PathGeometric.
    */
@@ -116,6 +159,9 @@ class AbstractPlanner {
   bool control_based_{false};
   explicit AbstractPlanner(const std::string &name);
 
+ private:
+  void setStartAndGoalStates(Environment &environment);
+
  public:
   virtual ob::Planner *omplPlanner() { return nullptr; }
   virtual nlohmann::json getSettings() const { return {};}
@@ -17,6 +17,8 @@ class OMPLAnytimePathShortening : public OMPLPlanner<PLANNER> {
 
   std::string name() const override { return "OMPL Anytime Path Shortening"; }
 
+  bool supportsCheckpoints() const override { return false; }
+
   virtual ob::PlannerStatus run() {
     ob::PlannerPtr planner;
     planner = std::make_shared<og::AnytimePathShortening>(
@@ -23,6 +23,7 @@
 #include <ompl/control/planners/sst/SST.h>
 
 #include "base/PlannerSettings.h"
+#include "fp_models/BatchDirectedControlSampler.hpp"
 #include "fp_models/kinematic_car/kinematic_car.hpp"
 #include "fp_models/kinematic_single_track/kinematic_single_track.hpp"
 
@@ -51,6 +52,14 @@ class OMPLControlPlanner : public AbstractPlanner {
 
     ss_c->setPlanner(_omplPlanner);
     this->setStatePropagator();
+    if (global::settings.forwardpropagation.batch_control_samples > 1) {
+      ss_c->getSpaceInformation()->setDirectedControlSamplerAllocator(
+          [](const oc::SpaceInformation *si) -> oc::DirectedControlSamplerPtr {
+            return std::make_shared<
+                ForwardPropagation::BatchDirectedControlSampler>(
+                si, global::settings.forwardpropagation.batch_control_samples);
+          });
+    }
     ss_c->getSpaceInformation()->setPropagationStepSize(.1);
     ss_c->getSpaceInformation()->setMinMaxControlDuration(2, 10);
     ss_c->setup();
@@ -101,27 +110,26 @@ class OMPLControlPlanner : public AbstractPlanner {
    * @return void
    */
   void setStatePropagator() {
+    const auto *si = ss_c->getSpaceInformation().get();
     if (global::settings.forwardpropagation.forward_propagation_type ==
         ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_CAR) {
       std::cout << "Setting KinematicCar" << std::endl;
-      auto odeSolver(std::make_shared<oc::ODEBasicSolver<>>(
-          ss_c->getSpaceInformation(), &KinematicCar::kinematicCarODE));
-
-      ss_c->setStatePropagator(oc::ODESolver::getStatePropagator(
-          odeSolver, &KinematicCar::kinematicCarPostIntegration));
+      ss_c->setStatePropagator(
+          [si](const ob::State *state, const oc::Control *control,
+               const double duration, ob::State *result) {
+            KinematicCar::propagate(si, state, control, duration, result);
+          });
     }
 
     if (global::settings.forwardpropagation.forward_propagation_type ==
         ForwardPropagation::FORWARD_PROPAGATION_TYPE_KINEMATIC_SINGLE_TRACK) {
-      std::cout << "Setting kinematicSingleTrackODE" << std::endl;
-
-      auto odeSolver(std::make_shared<oc::ODEBasicSolver<>>(
-          ss_c->getSpaceInformation(),
-          &kinematicSingleTrack::kinematicSingleTrackODE));
-
-      ss_c->setStatePropagator(oc::ODESolver::getStatePropagator(
-          odeSolver,
-          &kinematicSingleTrack::kinematicSingleTrackPostIntegration));
+      std::cout << "Setting kinematicSingleTrack" << std::endl;
+      ss_c->setStatePropagator(
+          [si](const ob::State *state, const oc::Control *control,
+               const double duration, ob::State *result) {
+            kinematicSingleTrack::propagate(si, state, control, duration,
+                                            result);
+          });
     }
   }
 
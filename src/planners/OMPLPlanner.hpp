@@ -37,11 +37,18 @@
 #include <ompl/geometric/planners/sst/SST.h>
 #include <ompl/geometric/planners/stride/STRIDE.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <type_traits>
 
 #include "base/PlannerSettings.h"
 #include "planners/AbstractPlanner.h"
+#include "planners/RoadmapCache.h"
 #include "utils/PlannerUtils.hpp"
+#include "utils/SteerAwareNearestNeighbors.hpp"
 #include "utils/Stopwatch.hpp"
 
 namespace ob = ompl::base;
@@ -51,14 +58,41 @@ namespace oc = ompl::control;
 template <class PLANNER>
 class OMPLPlanner : public AbstractPlanner {
  public:
+  /**
+   * Multi-query planners whose roadmap can be reused by later runs (see
+   * RoadmapCache).
+   */
+  static constexpr bool IsRoadmapPlanner =
+      std::is_base_of_v<og::PRM, PLANNER> ||
+      std::is_base_of_v<og::SPARS, PLANNER> ||
+      std::is_base_of_v<og::SPARStwo, PLANNER>;
+
   OMPLPlanner() : AbstractPlanner("OMPL") {
     _omplPlanner = ob::PlannerPtr(new PLANNER(ss->getSpaceInformation()));
+    _ownPlanner = _omplPlanner;
     AbstractPlanner::LastCreatedPlannerName = name();
   }
 
+  bool reset(Environment &environment) override {
+    // a roadmap restored from the RoadmapCache is shared with the cache and
+    // must not be cleared
+    if (_omplPlanner != _ownPlanner) {
+      _omplPlanner = _ownPlanner;
+      ss->setPlanner(_omplPlanner);
+    }
+    return AbstractPlanner::reset(environment);
+  }
+
   ob::PlannerStatus run() override {
     intermediarySolutions.clear();
 
+    std::uint64_t roadmap_key = 0;
+    if constexpr (IsRoadmapPlanner) {
+      if (global::settings.ompl.roadmap_cache.enabled) {
+        roadmap_key = RoadmapCache::key(*_omplPlanner);
+        restoreRoadmap(roadmap_key);
+      }
+    }
     ss->setPlanner(_omplPlanner);
     ss->setup();
 
@@ -77,8 +111,41 @@ class OMPLPlanner : public AbstractPlanner {
           intermediarySolutions.emplace_back(is);
         });
 
+    checkpointSolutions.clear();
+    // PRM, SPARS and CForest evaluate the termination condition from several
+    // threads, which claim each checkpoint once and record it exclusively
+    std::atomic<std::size_t> next_checkpoint{0};
+    std::mutex checkpoint_mutex;
     watch.start();
-    auto solved = ss->solve(global::settings.max_planning_time);
+    auto ptc = ob::timedPlannerTerminationCondition(
+        global::settings.max_planning_time);
+    if (!checkpoints.empty()) {
+      // only records the best solution when a checkpoint has been reached,
+      // the evaluation of the snapshots is left to the caller
+      ptc = ob::plannerOrTerminationCondition(
+          ptc, ob::PlannerTerminationCondition([&]() {
+            std::size_t index = next_checkpoint.load();
+            while (index < checkpoints.size() &&
+                   watch.elapsed() >= checkpoints[index]) {
+              if (!next_checkpoint.compare_exchange_weak(index, index + 1))
+                continue;
+              std::lock_guard<std::mutex> lock(checkpoint_mutex);
+              recordCheckpoint(*problem, checkpoints[index++]);
+            }
+            return false;
+          }));
+    }
+    auto solved = ss->solve(ptc);
+    // the planner threads have finished, but may have recorded their
+    // checkpoints out of order
+    std::stable_sort(checkpointSolutions.begin(), checkpointSolutions.end(),
+                     [](const IntermediarySolution &a,
+                        const IntermediarySolution &b) {
+                       return a.time < b.time;
+                     });
+    for (std::size_t i = next_checkpoint; i < checkpoints.size(); ++i)
+      recordCheckpoint(
+          *problem, std::min(checkpoints[i], ss->getLastPlanComputationTime()));
     OMPL_INFORM("OMPL %s planning status: %s", _omplPlanner->getName().c_str(),
                 solved.asString().c_str());
 
@@ -98,6 +165,11 @@ class OMPLPlanner : public AbstractPlanner {
           _solution.cost(ss->getOptimizationObjective()));
     } else
       OMPL_WARN("No solution found.");
+
+    if constexpr (IsRoadmapPlanner) {
+      if (global::settings.ompl.roadmap_cache.enabled)
+        storeRoadmap(roadmap_key);
+    }
     return solved;
   }
 
@@ -118,6 +190,8 @@ class OMPLPlanner : public AbstractPlanner {
 
   ob::Planner *omplPlanner() override { return _omplPlanner.get(); }
 
+  bool supportsCheckpoints() const override { return true; }
+
   virtual nlohmann::json getSettings() const override {
     nlohmann::json settings;
     const auto &param_map = _omplPlanner->params().getParams();
@@ -128,7 +202,99 @@ class OMPLPlanner : public AbstractPlanner {
   }
 
  private:
+  /**
+   * Stores a copy of the best solution of the problem definition (or an
+   * empty path if none has been found yet) as checkpoint solution, together
+   * with the collision checking and steering time spent so far.
+   */
+  void recordCheckpoint(const ob::ProblemDefinition &problem, double time) {
+    og::PathGeometric solution(global::settings.ompl.space_info);
+    if (problem.hasSolution()) {
+      const auto path = problem.getSolutionPath()->as<og::PathGeometric>();
+      solution.append(global::settings.environment->startState());
+      for (std::size_t i = 0; i < path->getStateCount(); ++i)
+        solution.append(path->getState(i));
+    }
+    auto &checkpoint = checkpointSolutions.emplace_back(
+        time, std::numeric_limits<double>::quiet_NaN(), solution);
+    checkpoint.collision_time =
+        global::settings.environment->elapsedCollisionTime();
+    checkpoint.steering_time = global::settings.ompl.steering_timer.elapsed();
+  }
+
+  /**
+   * Replaces the planner by the one holding the cached roadmap of the given
+   * key, if it is kept in memory or, for PRM and PRM*, stored on disk.
+   */
+  void restoreRoadmap(std::uint64_t key) {
+    roadmapStatistics = RoadmapStatistics();
+    RoadmapCache::Entry entry;
+    if (RoadmapCache::find(key, entry)) {
+      _omplPlanner = entry.planner;
+      _omplPlanner->clearQuery();
+      roadmapStatistics.reused = true;
+      roadmapStatistics.construction_time = entry.construction_time;
+      roadmapStatistics.load_time = 0;
+    } else if constexpr (std::is_base_of_v<og::PRM, PLANNER>) {
+      if (!global::settings.ompl.roadmap_cache.persist) return;
+      Stopwatch watch;
+      watch.start();
+      ob::PlannerData data(global::settings.ompl.space_info);
+      double construction_time;
+      if (!RoadmapCache::load(key, data, construction_time)) return;
+      // the nearest-neighbor structure is rebuilt from the loaded vertices
+      auto planner = std::make_shared<og::PRM>(
+          data, std::is_base_of_v<og::PRMstar, PLANNER>);
+      planner->setName(_omplPlanner->getName());
+      for (const auto &[name, param] : _omplPlanner->params().getParams()) {
+        if (planner->params().hasParam(name))
+          planner->params().setParam(name, param->getValue());
+      }
+      // the loaded roadmap uses PRM's default nearest neighbors, which are
+      // replaced as configured for the planner of this instance (see
+      // PlannerConfigurator)
+      if (global::settings.ompl.nearest_neighbors.value() == "steer_aware" &&
+          global::settings.ompl.optimization_objective.value() ==
+              "min_pathlength")
+        steer_aware_nn::usePRM(*planner);
+      _omplPlanner = planner;
+      roadmapStatistics.reused = true;
+      roadmapStatistics.construction_time = construction_time;
+      roadmapStatistics.load_time = watch.stop();
+      OMPL_INFORM("Loaded %s roadmap with %u vertices in %.3fs.",
+                  planner->getName().c_str(), data.numVertices(),
+                  roadmapStatistics.load_time);
+    }
+  }
+
+  /**
+   * Keeps the roadmap of the last run in memory and, if it has been
+   * constructed by this run, writes PRM and PRM* roadmaps to disk.
+   */
+  void storeRoadmap(std::uint64_t key) {
+    const double time = planningTime();
+    if (roadmapStatistics.reused) {
+      roadmapStatistics.query_time = time;
+      RoadmapCache::insert(key,
+                           {_omplPlanner, roadmapStatistics.construction_time});
+      return;
+    }
+    roadmapStatistics.construction_time = time;
+    RoadmapCache::insert(key, {_omplPlanner, time});
+    if constexpr (std::is_base_of_v<og::PRM, PLANNER>) {
+      if (!global::settings.ompl.roadmap_cache.persist) return;
+      ob::PlannerData data(global::settings.ompl.space_info);
+      _omplPlanner->getPlannerData(data);
+      if (!RoadmapCache::save(key, data, time))
+        OMPL_WARN("Could not save the %s roadmap.",
+                  _omplPlanner->getName().c_str());
+    }
+  }
+
   ob::PlannerPtr _omplPlanner;
+  // the planner constructed for this instance, which differs from
+  // _omplPlanner while a cached roadmap is used
+  ob::PlannerPtr _ownPlanner;
   og::PathGeometric _solution{global::settings.ompl.space_info};
 };
 
@@ -0,0 +1,23 @@
+#include "planners/PlannerPool.h"
+
+#include <nlohmann/json.hpp>
+
+#include "utils/ContentHash.hpp"
+
+std::uint64_t PlannerPool::settingsHash() {
+  nlohmann::json settings = nlohmann::json(global::settings)["settings"];
+  settings.erase("benchmark");
+  settings.erase("max_planning_time");
+  settings["env"].erase("start");
+  settings["env"].erase("goal");
+  settings["control_planners_on"] =
+      global::settings.benchmark.control_planners_on.value();
+
+  ContentHash hash;
+  for (const void *identity :
+       {(const void *)global::settings.environment.get(),
+        (const void *)global::settings.ompl.space_info.get(),
+        (const void *)global::settings.ompl.control_space_info.get()})
+    hash.add(identity);
+  return hash.add(settings.dump()).value();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+#include "base/PlannerConfigurator.hpp"
+#include "base/PlannerSettings.h"
+#include "planners/AbstractPlanner.h"
+
+/**
+ * Per-thread pool of configured planners, keyed by planner type and a hash of
+ * the settings they were constructed with. Instead of constructing,
+ * configuring and setting up a planner for every run, pooled planners are
+ * reset (see AbstractPlanner::reset) and reused as long as the environment,
+ * the state space and the settings remain unchanged, e.g. between the
+ * scenarios of a Moving AI map.
+ *
+ * Enabled by global::settings.benchmark.reuse_planners.
+ */
+class PlannerPool {
+ public:
+  PlannerPool() = delete;
+
+  /**
+   * Returns a configured planner that is ready to run in the current
+   * environment. The planner is owned by the pool. Exceptions thrown while
+   * constructing the planner are passed on to the caller.
+   */
+  template <class PLANNER>
+  static PLANNER *acquire() {
+    const std::uint64_t hash = settingsHash();
+    auto &entry = planners()[std::type_index(typeid(PLANNER))];
+    if (entry.planner && entry.settings_hash == hash &&
+        entry.planner->reset(*global::settings.environment)) {
+      AbstractPlanner::LastCreatedPlannerName = entry.planner->name();
+      return static_cast<PLANNER *>(entry.planner.get());
+    }
+    // release the previous planner before its replacement is set up
+    entry.planner.reset();
+    auto planner = std::make_unique<PLANNER>();
+    PlannerConfigurator::configure(*planner);
+    entry.settings_hash = hash;
+    entry.planner = std::move(planner);
+    return static_cast<PLANNER *>(entry.planner.get());
+  }
+
+  /**
+   * Destroys all planners pooled by the calling thread.
+   */
+  static void clear() { planners().clear(); }
+
+ private:
+  struct Entry {
+    std::uint64_t settings_hash{0};
+    std::unique_ptr<AbstractPlanner> planner;
+  };
+
+  static std::unordered_map<std::type_index, Entry> &planners() {
+    thread_local std::unordered_map<std::type_index, Entry> pool;
+    return pool;
+  }
+
+  /**
+   * Hash of the settings that affect the construction of planners, including
+   * the identities of the environment and state space. Start and goal, the
+   * time limit and the benchmark settings are excluded.
+   */
+  static std::uint64_t settingsHash();
+};
@@ -0,0 +1,108 @@
+#include "planners/RoadmapCache.h"
+
+#include <ompl/base/PlannerDataStorage.h>
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+#include "base/Environment.h"
+#include "base/PlannerSettings.h"
+#include "utils/ContentHash.hpp"
+#include "utils/LruCache.hpp"
+
+namespace {
+constexpr char Magic[8] = {'M', 'P', 'B', 'R', 'M', 'A', 'P', '1'};
+
+struct CacheEntry {
+  std::uint64_t key;
+  RoadmapCache::Entry entry;
+};
+
+LruCache<CacheEntry> cache;
+}  // namespace
+
+std::uint64_t RoadmapCache::key(const ob::Planner &planner) {
+  nlohmann::json params;
+  for (const auto &[name, param] : planner.params().getParams())
+    params[name] = param->getValue();
+  const nlohmann::json description{
+      {"planner", planner.getName()},
+      {"params", params},
+      {"steer", nlohmann::json(global::settings.steer)["steer"]},
+      {"collision",
+       nlohmann::json(global::settings.env.collision)["collision"]},
+      {"sampler", global::settings.ompl.sampler.value()},
+      {"nearest_neighbors", global::settings.ompl.nearest_neighbors.value()}};
+  return ContentHash()
+      .add(global::settings.environment->contentHash())
+      .add(description.dump())
+      .value();
+}
+
+bool RoadmapCache::find(std::uint64_t key, Entry &entry) {
+  CacheEntry cached;
+  if (!cache.find([key](const CacheEntry &e) { return e.key == key; },
+                  cached))
+    return false;
+  if (cached.entry.planner->getSpaceInformation() !=
+      global::settings.ompl.space_info) {
+    cache.remove([key](const CacheEntry &e) { return e.key == key; });
+    return false;
+  }
+  entry = cached.entry;
+  return true;
+}
+
+void RoadmapCache::insert(std::uint64_t key, const Entry &entry) {
+  cache.insert({key, entry},
+               global::settings.ompl.roadmap_cache.cache_size.value(),
+               [key](const CacheEntry &e) { return e.key == key; });
+}
+
+std::string RoadmapCache::filename(std::uint64_t key) {
+  std::stringstream ss;
+  ss << "roadmap_" << std::hex << std::setw(16) << std::setfill('0') << key
+     << ".bin";
+  return (boost::filesystem::path(
+              global::settings.ompl.roadmap_cache.cache_dir.value()) /
+          ss.str())
+      .string();
+}
+
+bool RoadmapCache::load(std::uint64_t key, ob::PlannerData &data,
+                        double &construction_time) {
+  std::ifstream file(filename(key), std::ios::binary);
+  if (!file.good()) return false;
+  char magic[sizeof(Magic)];
+  std::uint64_t stored_key;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&stored_key), sizeof(stored_key));
+  file.read(reinterpret_cast<char *>(&construction_time),
+            sizeof(construction_time));
+  if (!file.good() || std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+      stored_key != key)
+    return false;
+  ob::PlannerDataStorage storage;
+  return storage.load(file, data) && data.numVertices() > 0;
+}
+
+bool RoadmapCache::save(std::uint64_t key, const ob::PlannerData &data,
+                        double construction_time) {
+  boost::system::error_code error;
+  boost::filesystem::create_directories(
+      global::settings.ompl.roadmap_cache.cache_dir.value(), error);
+  const auto name = filename(key);
+  std::ofstream file(name, std::ios::binary);
+  if (!file.good()) return false;
+  file.write(Magic, sizeof(Magic));
+  file.write(reinterpret_cast<const char *>(&key), sizeof(key));
+  file.write(reinterpret_cast<const char *>(&construction_time),
+             sizeof(construction_time));
+  ob::PlannerDataStorage storage;
+  if (!storage.store(data, file)) return false;
+  return file.good();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ompl/base/Planner.h>
+#include <ompl/base/PlannerData.h>
+
+#include <cstdint>
+#include <string>
+
+namespace ob = ompl::base;
+
+/**
+ * Keeps the roadmaps of the multi-query planners PRM, PRM*, SPARS and SPARS2
+ * between runs, so that later queries on the same map only connect their
+ * start and goal states to the existing roadmap.
+ *
+ * Roadmaps are identified by the content hash of the environment, the
+ * steer function, the collision model, the sampler and the planner
+ * parameters. In memory, the planner instances themselves are kept, including
+ * their nearest-neighbor structures. The roadmaps of PRM and PRM* are
+ * additionally stored as binary PlannerData files from which they are
+ * reloaded (rebuilding the nearest-neighbor structure) once they have been
+ * evicted from memory, e.g. in subsequent benchmark invocations.
+ *
+ * Settings are found in global::settings.ompl.roadmap_cache.
+ */
+class RoadmapCache {
+ public:
+  struct Entry {
+    ob::PlannerPtr planner;
+    /**
+     * Time in seconds spent by the run that constructed the roadmap.
+     */
+    double construction_time;
+  };
+
+  RoadmapCache() = delete;
+
+  /**
+   * Hash identifying the roadmap the given planner constructs in the current
+   * environment with the current steer function and collision model.
+   */
+  static std::uint64_t key(const ob::Planner &planner);
+
+  /**
+   * Looks up the roadmap of the given key in memory. Roadmaps constructed in
+   * a different space information (e.g. before the steer function was
+   * reinitialized) are discarded.
+   */
+  static bool find(std::uint64_t key, Entry &entry);
+
+  static void insert(std::uint64_t key, const Entry &entry);
+
+  /**
+   * Loads the roadmap file of the given key into data, which needs to be
+   * constructed with the current space information.
+   */
+  static bool load(std::uint64_t key, ob::PlannerData &data,
+                   double &construction_time);
+
+  static bool save(std::uint64_t key, const ob::PlannerData &data,
+                   double construction_time);
+
+ private:
+  static std::string filename(std::uint64_t key);
+};
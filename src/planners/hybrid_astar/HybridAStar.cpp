@@ -0,0 +1,261 @@
+#include "planners/hybrid_astar/HybridAStar.h"
+
+#include <ompl/base/spaces/DubinsStateSpace.h>
+#include <ompl/base/spaces/ReedsSheppStateSpace.h>
+
+#include <cmath>
+#include <functional>
+#include <queue>
+
+#include "base/HeuristicTable.h"
+#include "steer_functions/SteerDistanceTable.h"
+#include "utils/PlannerUtils.hpp"
+#include "utils/Stopwatch.hpp"
+
+namespace {
+bool drivesBackwards(Steering::SteeringType type) {
+  return type == Steering::STEER_TYPE_REEDS_SHEPP ||
+         type == Steering::STEER_TYPE_HC_REEDS_SHEPP ||
+         type == Steering::STEER_TYPE_CC_REEDS_SHEPP ||
+         type == Steering::STEER_TYPE_LINEAR;
+}
+
+double turningRadius(Steering::SteeringType type) {
+  if (type == Steering::STEER_TYPE_CC_DUBINS ||
+      type == Steering::STEER_TYPE_HC_REEDS_SHEPP ||
+      type == Steering::STEER_TYPE_CC_REEDS_SHEPP)
+    return 1. / global::settings.steer.hc_cc.kappa;
+  return global::settings.steer.car_turning_radius;
+}
+
+void setState(ob::State *state, double x, double y, double theta) {
+  auto *s = state->as<State>();
+  s->setXY(x, y);
+  s->setYaw(theta);
+}
+}  // namespace
+
+HybridAStar::HybridAStar()
+    : AbstractPlanner(name()), _solution(global::settings.ompl.space_info) {
+  const auto type = global::settings.steer.steering_type.value();
+  _turningRadius = turningRadius(type);
+  // steer functions without curvature constraint only use the holonomic
+  // heuristic
+  if (type != Steering::STEER_TYPE_LINEAR &&
+      type != Steering::STEER_TYPE_POSQ) {
+    const bool reeds_shepp = drivesBackwards(type);
+    if (reeds_shepp)
+      _nonholonomicSpace =
+          std::make_shared<ob::ReedsSheppStateSpace>(_turningRadius);
+    else
+      _nonholonomicSpace =
+          std::make_shared<ob::DubinsStateSpace>(_turningRadius);
+    if (global::settings.hybridAStar.nonholonomic_table) {
+      const auto &table = global::settings.steer.distance_table;
+      _nonholonomicTable = SteerDistanceTable::loadOrGenerate(
+          reeds_shepp ? Steering::STEER_TYPE_REEDS_SHEPP
+                      : Steering::STEER_TYPE_DUBINS,
+          table.extent, table.cells_xy, table.cells_theta,
+          table.max_cell_spread, table.cache_dir);
+    }
+    _hFrom = _nonholonomicSpace->allocState();
+    _hGoal = _nonholonomicSpace->allocState();
+  }
+  _from = global::settings.ompl.state_space->allocState();
+  _to = global::settings.ompl.state_space->allocState();
+  _goal = global::settings.ompl.state_space->allocState();
+}
+
+HybridAStar::~HybridAStar() {
+  global::settings.ompl.state_space->freeState(_from);
+  global::settings.ompl.state_space->freeState(_to);
+  global::settings.ompl.state_space->freeState(_goal);
+  if (_nonholonomicSpace) {
+    _nonholonomicSpace->freeState(_hFrom);
+    _nonholonomicSpace->freeState(_hGoal);
+  }
+}
+
+nlohmann::json HybridAStar::getSettings() const {
+  const auto &settings = global::settings.hybridAStar;
+  return {{"resolution", settings.resolution.value()},
+          {"theta_bins", settings.theta_bins.value()},
+          {"step_size", settings.step_size.value()},
+          {"curvature_steps", settings.curvature_steps.value()},
+          {"reverse_penalty", settings.reverse_penalty.value()},
+          {"steering_penalty", settings.steering_penalty.value()},
+          {"direction_switch_penalty",
+           settings.direction_switch_penalty.value()},
+          {"analytic_expansion_interval",
+           settings.analytic_expansion_interval.value()},
+          {"nonholonomic_table", settings.nonholonomic_table.value()},
+          {"turning_radius", _turningRadius}};
+}
+
+std::int64_t HybridAStar::cellIndex(double x, double y, double theta) const {
+  const double cx = std::floor((x - _minX) / _cellSize);
+  const double cy = std::floor((y - _minY) / _cellSize);
+  if (cx < 0 || cy < 0 || cx >= _cellsX || cy >= _cellsY) return -1;
+  double t = std::fmod(theta, 2. * M_PI);
+  if (t < 0) t += 2. * M_PI;
+  const auto ct = std::min(_thetaBins - 1,
+                           (unsigned int)(t / (2. * M_PI) * _thetaBins));
+  return ((std::int64_t)ct * _cellsY + (std::int64_t)cy) * _cellsX +
+         (std::int64_t)cx;
+}
+
+double HybridAStar::heuristic(double x, double y, double theta) {
+  double h = _holonomic->costToGo(x, y);
+  if (_nonholonomicSpace) {
+    setState(_hFrom, x, y, theta);
+    double d = -1;
+    if (_nonholonomicTable)
+      d = _nonholonomicTable->distance(_hFrom, _hGoal, _turningRadius);
+    if (d < 0) d = _nonholonomicSpace->distance(_hFrom, _hGoal);
+    h = std::max(h, d);
+  }
+  return h;
+}
+
+bool HybridAStar::motionValid(const Node &from, double x, double y,
+                              double theta) {
+  setState(_from, from.x, from.y, from.theta);
+  setState(_to, x, y, theta);
+  return !PlannerUtils::collides(_from, _to);
+}
+
+void HybridAStar::buildSolution(std::int32_t last) {
+  std::vector<std::int32_t> indices;
+  for (std::int32_t i = last; i >= 0; i = _nodes[i].parent)
+    indices.push_back(i);
+  _solution.clear();
+  for (auto it = indices.rbegin(); it != indices.rend(); ++it) {
+    const auto &node = _nodes[*it];
+    setState(_to, node.x, node.y, node.theta);
+    _solution.append(_to);
+  }
+  _solution.append(_goal);
+}
+
+ob::PlannerStatus HybridAStar::run() {
+  _solved = false;
+  _solution.clear();
+  _expansions = 0;
+  _nodes.clear();
+  Stopwatch watch;
+  watch.start();
+
+  auto &environment = *global::settings.environment;
+  const auto &settings = global::settings.hybridAStar;
+  const auto &bounds = environment.bounds();
+  _cellSize = settings.resolution * environment.unit();
+  _minX = bounds.low[0];
+  _minY = bounds.low[1];
+  _cellsX = (unsigned int)std::max(
+      1., std::ceil((bounds.high[0] - _minX) / _cellSize));
+  _cellsY = (unsigned int)std::max(
+      1., std::ceil((bounds.high[1] - _minY) / _cellSize));
+  _thetaBins = std::max(1u, settings.theta_bins.value());
+  _closed.assign(((std::size_t)_cellsX * _cellsY * _thetaBins + 63) / 64, 0);
+
+  const Point start = environment.start(), goal = environment.goal();
+  setState(_goal, goal.x, goal.y, environment.goalTheta());
+  if (_nonholonomicSpace)
+    setState(_hGoal, goal.x, goal.y, environment.goalTheta());
+  _holonomic = HeuristicTable::get(environment, goal);
+
+  setState(_from, start.x, start.y, environment.startTheta());
+  if (!environment.checkValidity(_from)) {
+    _planningTime = watch.stop();
+    OMPL_ERROR("Hybrid A*: The start state is invalid.");
+    return ob::PlannerStatus::INVALID_START;
+  }
+
+  // motion primitives
+  const double step = settings.step_size * _cellSize;
+  std::vector<double> curvatures;
+  const int curvature_steps = (int)settings.curvature_steps.value();
+  for (int i = -curvature_steps; i <= curvature_steps; ++i)
+    curvatures.push_back(
+        curvature_steps > 0 ? i / (curvature_steps * _turningRadius) : 0.);
+  std::vector<std::int8_t> directions{1};
+  if (drivesBackwards(global::settings.steer.steering_type.value()))
+    directions.push_back(-1);
+  const unsigned int interval =
+      std::max(1u, settings.analytic_expansion_interval.value());
+
+  typedef std::pair<double, std::int32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  _nodes.push_back({start.x, start.y, environment.startTheta(), 0., -1, 1});
+  open.emplace(heuristic(start.x, start.y, environment.startTheta()), 0);
+
+  bool timeout = false;
+  while (!open.empty()) {
+    const std::int32_t current = open.top().second;
+    open.pop();
+    // copy since the arena grows while the successors are added
+    const Node node = _nodes[current];
+    const std::int64_t cell = cellIndex(node.x, node.y, node.theta);
+    if (cell < 0) continue;
+    if (_closed[cell / 64] & (1ull << (cell % 64))) continue;
+    _closed[cell / 64] |= 1ull << (cell % 64);
+
+    if (_expansions++ % interval == 0) {
+      setState(_from, node.x, node.y, node.theta);
+      if (!PlannerUtils::collides(_from, _goal)) {
+        buildSolution(current);
+        _solved = true;
+        break;
+      }
+    }
+    if ((_expansions & 63u) == 0 &&
+        watch.elapsed() > global::settings.max_planning_time) {
+      timeout = true;
+      break;
+    }
+
+    for (const auto direction : directions) {
+      const double s = direction * step;
+      for (const double curvature : curvatures) {
+        double x, y, theta;
+        if (curvature == 0) {
+          x = node.x + s * std::cos(node.theta);
+          y = node.y + s * std::sin(node.theta);
+          theta = node.theta;
+        } else {
+          theta = node.theta + curvature * s;
+          x = node.x + (std::sin(theta) - std::sin(node.theta)) / curvature;
+          y = node.y - (std::cos(theta) - std::cos(node.theta)) / curvature;
+        }
+        theta = PlannerUtils::normalizeAngle(theta);
+        const std::int64_t next = cellIndex(x, y, theta);
+        if (next < 0 || (_closed[next / 64] & (1ull << (next % 64))))
+          continue;
+        if (!motionValid(node, x, y, theta)) continue;
+
+        // the motion is the steer function's connection between the states,
+        // which only coincides with the arc for curvature-limited steering
+        double cost = global::settings.ompl.state_space->distance(_from, _to);
+        if (direction < 0) cost *= settings.reverse_penalty;
+        if (curvature != 0) cost *= settings.steering_penalty;
+        if (node.parent >= 0 && direction != node.direction)
+          cost += settings.direction_switch_penalty * step;
+        _nodes.push_back({x, y, theta, node.g + cost, current, direction});
+        open.emplace(node.g + cost + heuristic(x, y, theta),
+                     (std::int32_t)(_nodes.size() - 1));
+      }
+    }
+  }
+
+  _planningTime = watch.stop();
+  OMPL_DEBUG("Hybrid A*: Expanded %u nodes, generated %u nodes.",
+             _expansions, (unsigned int)_nodes.size());
+  if (!_solved) {
+    if (timeout)
+      OMPL_WARN("Hybrid A* could not finish within the allotted time limit.");
+    else
+      OMPL_WARN("Hybrid A*: No path found.");
+    return ob::PlannerStatus::TIMEOUT;
+  }
+  return ob::PlannerStatus::EXACT_SOLUTION;
+}
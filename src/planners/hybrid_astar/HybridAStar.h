@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ompl/geometric/PathGeometric.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/PlannerSettings.h"
+#include "planners/AbstractPlanner.h"
+
+class HeuristicTable;
+class SteerDistanceTable;
+
+namespace ob = ompl::base;
+namespace og = ompl::geometric;
+
+/**
+ * Hybrid A* search over continuous SE(2) states, whose closed set
+ * discretizes (x, y, heading) into cells. Successors are generated by
+ * circular arcs up to the maximum curvature of the configured steer function,
+ * driving backwards only if the steer function can (Reeds-Shepp variants and
+ * linear steering). Every motion is the steer function's connection between
+ * the states, which is checked for collisions and costs its length, and an
+ * analytic expansion connecting the node to the goal with the steer function
+ * is tried periodically.
+ *
+ * The heuristic is the maximum of the non-holonomic distance ignoring
+ * obstacles (Reeds-Shepp or Dubins) and the holonomic distance around
+ * obstacles from the HeuristicTable.
+ *
+ * Settings are found in global::settings.hybridAStar.
+ */
+class HybridAStar : public AbstractPlanner {
+ public:
+  HybridAStar();
+  ~HybridAStar() override;
+
+  std::string name() const override { return "Hybrid A*"; }
+
+  ob::PlannerStatus run() override;
+
+  og::PathGeometric solution() const override { return _solution; }
+
+  bool hasReachedGoalExactly() const override { return _solved; }
+  double planningTime() const override { return _planningTime; }
+
+  /**
+   * Number of nodes expanded by the last search.
+   */
+  unsigned int expansions() const { return _expansions; }
+
+  nlohmann::json getSettings() const override;
+
+ private:
+  struct Node {
+    double x, y, theta;
+    double g;
+    std::int32_t parent;
+    // +1 when the node was reached driving forward, -1 backwards
+    std::int8_t direction;
+  };
+
+  /**
+   * Index of the (x, y, heading) cell of the closed set, or -1 if the
+   * position lies outside the environment.
+   */
+  std::int64_t cellIndex(double x, double y, double theta) const;
+
+  double heuristic(double x, double y, double theta);
+
+  bool motionValid(const Node &from, double x, double y, double theta);
+
+  void buildSolution(std::int32_t last);
+
+  og::PathGeometric _solution;
+  bool _solved{false};
+  double _planningTime{0};
+  unsigned int _expansions{0};
+
+  // node arena and closed set, reused between runs
+  std::vector<Node> _nodes;
+  std::vector<std::uint64_t> _closed;
+
+  double _minX{0}, _minY{0}, _cellSize{1};
+  unsigned int _cellsX{0}, _cellsY{0}, _thetaBins{1};
+
+  std::shared_ptr<const HeuristicTable> _holonomic;
+  std::shared_ptr<const SteerDistanceTable> _nonholonomicTable;
+  ob::StateSpacePtr _nonholonomicSpace;
+  double _turningRadius{1};
+
+  // states of the steer function's state space
+  ob::State *_from{nullptr};
+  ob::State *_to{nullptr};
+  ob::State *_goal{nullptr};
+  // states of the non-holonomic heuristic's state space
+  ob::State *_hFrom{nullptr};
+  ob::State *_hGoal{nullptr};
+};
@@ -0,0 +1,337 @@
+#include "planners/jps/JumpPointGrid.h"
+
+#include <ompl/base/spaces/SE2StateSpace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "base/Environment.h"
+#include "base/PlannerSettings.h"
+#include "utils/LruCache.hpp"
+
+namespace {
+// straight directions first, followed by the diagonal ones
+constexpr int DX[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+constexpr int DY[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+
+int direction(int dx, int dy) {
+  for (int i = 0; i < 8; ++i)
+    if (DX[i] == dx && DY[i] == dy) return i;
+  return -1;
+}
+
+int sign(int v) { return (v > 0) - (v < 0); }
+
+double octile(int dx, int dy) {
+  dx = std::abs(dx);
+  dy = std::abs(dy);
+  return std::max(dx, dy) + (std::sqrt(2.) - 1.) * std::min(dx, dy);
+}
+
+struct CacheEntry {
+  std::uint64_t key;
+  std::shared_ptr<const JumpPointGrid> grid;
+};
+
+LruCache<CacheEntry> cache;
+}  // namespace
+
+std::shared_ptr<const JumpPointGrid> JumpPointGrid::get(
+    Environment &environment, bool jump_table) {
+  const double resolution = environment.unit();
+  const auto &bounds = environment.bounds();
+  const double origin_x = std::ceil(bounds.low[0] / resolution) * resolution;
+  const double origin_y = std::ceil(bounds.low[1] / resolution) * resolution;
+  const int cells_x = std::max(
+      1, (int)std::floor((bounds.high[0] - origin_x) / resolution) + 1);
+  const int cells_y = std::max(
+      1, (int)std::floor((bounds.high[1] - origin_y) / resolution) + 1);
+
+  // the vertex occupancy depends on the environment and the collision model
+  const std::uint64_t key =
+      ContentHash()
+          .add(environment.contentHash())
+          .add(nlohmann::json(global::settings.env.collision).dump())
+          .add(resolution)
+          .value();
+  CacheEntry entry;
+  if (cache.find(
+          [&](const CacheEntry &e) {
+            return e.key == key && (e.grid->hasJumpTable() || !jump_table);
+          },
+          entry))
+    return entry.grid;
+
+  ob::SE2StateSpace space;
+  auto *state = space.allocState()->as<ob::SE2StateSpace::StateType>();
+  state->setYaw(0);
+  std::vector<unsigned char> occupied((std::size_t)cells_x * cells_y);
+  for (int y = 0; y < cells_y; ++y) {
+    unsigned char *row = occupied.data() + (std::size_t)y * cells_x;
+    for (int x = 0; x < cells_x; ++x) {
+      state->setXY(origin_x + x * resolution, origin_y + y * resolution);
+      row[x] = !environment.checkValidity(state);
+    }
+  }
+  space.freeState(state);
+
+  auto grid = std::make_shared<const JumpPointGrid>(
+      origin_x, origin_y, resolution, cells_x, cells_y, std::move(occupied),
+      jump_table);
+  // a grid with jump table replaces the same grid without one
+  cache.insert({key, grid}, global::settings.jps.cache_size.value(),
+               [key](const CacheEntry &e) { return e.key == key; });
+  return grid;
+}
+
+JumpPointGrid::JumpPointGrid(double origin_x, double origin_y,
+                             double resolution, int cells_x, int cells_y,
+                             std::vector<unsigned char> occupied,
+                             bool jump_table)
+    : origin_x_(origin_x),
+      origin_y_(origin_y),
+      resolution_(resolution),
+      cells_x_(cells_x),
+      cells_y_(cells_y),
+      occupied_(std::move(occupied)) {
+  if (jump_table) computeJumpTable();
+}
+
+JumpPointGrid::Cell JumpPointGrid::cell(double x, double y) const {
+  const double gx = std::round(toGridX(x)), gy = std::round(toGridY(y));
+  return {(int)std::min<double>(cells_x_ - 1, std::max(0., gx)),
+          (int)std::min<double>(cells_y_ - 1, std::max(0., gy))};
+}
+
+bool JumpPointGrid::forced(int x, int y, int dx, int dy) const {
+  if (dx != 0)
+    return (free(x, y + 1) && !free(x - dx, y + 1)) ||
+           (free(x, y - 1) && !free(x - dx, y - 1));
+  return (free(x + 1, y) && !free(x + 1, y - dy)) ||
+         (free(x - 1, y) && !free(x - 1, y - dy));
+}
+
+int JumpPointGrid::successorDirections(int x, int y, int parent,
+                                       int *directions) const {
+  int n = 0;
+  if (parent < 0) {
+    for (int i = 0; i < 8; ++i) directions[n++] = i;
+    return n;
+  }
+  const int dx = DX[parent], dy = DY[parent];
+  directions[n++] = parent;
+  if (dx != 0 && dy != 0) {
+    directions[n++] = direction(dx, 0);
+    directions[n++] = direction(0, dy);
+  } else if (dx != 0) {
+    for (const int s : {1, -1}) {
+      if (free(x, y + s) && !free(x - dx, y + s)) {
+        directions[n++] = direction(0, s);
+        directions[n++] = direction(dx, s);
+      }
+    }
+  } else {
+    for (const int s : {1, -1}) {
+      if (free(x + s, y) && !free(x + s, y - dy)) {
+        directions[n++] = direction(s, 0);
+        directions[n++] = direction(s, dy);
+      }
+    }
+  }
+  return n;
+}
+
+bool JumpPointGrid::jump(int x, int y, int dx, int dy, const Cell &goal,
+                         Cell &result) const {
+  Cell unused;
+  while (canMove(x, y, dx, dy)) {
+    x += dx;
+    y += dy;
+    if ((x == goal.x && y == goal.y) ||
+        (dx != 0 && dy != 0
+             ? jump(x, y, dx, 0, goal, unused) ||
+                   jump(x, y, 0, dy, goal, unused)
+             : forced(x, y, dx, dy))) {
+      result = {x, y};
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JumpPointGrid::jumpTable(int x, int y, int direction, const Cell &goal,
+                              Cell &result) const {
+  const int dx = DX[direction], dy = DY[direction];
+  const int distance = jumps_[index(x, y) * 8 + direction];
+  const int reach = std::abs(distance);
+  const int gx = goal.x - x, gy = goal.y - y;
+  if (dx != 0 && dy != 0) {
+    // stop at the row or column of the goal if it lies in this quadrant
+    if (sign(gx) == dx && sign(gy) == dy) {
+      const int steps = std::min(std::abs(gx), std::abs(gy));
+      if (steps <= reach) {
+        result = {x + steps * dx, y + steps * dy};
+        return true;
+      }
+    }
+  } else if ((dx != 0 && gy == 0 && sign(gx) == dx &&
+              std::abs(gx) <= reach) ||
+             (dy != 0 && gx == 0 && sign(gy) == dy &&
+              std::abs(gy) <= reach)) {
+    result = goal;
+    return true;
+  }
+  if (distance <= 0) return false;
+  result = {x + distance * dx, y + distance * dy};
+  return true;
+}
+
+void JumpPointGrid::computeJumpTable() {
+  jumps_.assign((std::size_t)cells_x_ * cells_y_ * 8, 0);
+  // the diagonal distances depend on the straight ones of the next vertex
+  for (int d = 0; d < 8; ++d) {
+    const int dx = DX[d], dy = DY[d];
+    // visit the next vertex in direction d before the current one
+    const int x0 = dx > 0 ? cells_x_ - 1 : 0, x_step = dx > 0 ? -1 : 1;
+    const int y0 = dy > 0 ? cells_y_ - 1 : 0, y_step = dy > 0 ? -1 : 1;
+    for (int y = y0; y >= 0 && y < cells_y_; y += y_step) {
+      for (int x = x0; x >= 0 && x < cells_x_; x += x_step) {
+        if (!free(x, y) || !canMove(x, y, dx, dy)) continue;
+        const int nx = x + dx, ny = y + dy;
+        const std::size_t next = index(nx, ny) * 8;
+        bool jump_point;
+        if (dx != 0 && dy != 0)
+          jump_point = jumps_[next + direction(dx, 0)] > 0 ||
+                       jumps_[next + direction(0, dy)] > 0;
+        else
+          jump_point = forced(nx, ny, dx, dy);
+        const std::int32_t distance = jumps_[next + d];
+        jumps_[index(x, y) * 8 + d] =
+            jump_point ? 1 : (distance > 0 ? distance + 1 : distance - 1);
+      }
+    }
+  }
+}
+
+bool JumpPointGrid::search(const Cell &start, const Cell &goal,
+                           std::vector<Cell> &path, double max_time,
+                           unsigned int &expansions) const {
+  path.clear();
+  expansions = 0;
+  if (!free(start) || !free(goal)) return false;
+
+  const auto started = std::chrono::steady_clock::now();
+  const std::size_t size = (std::size_t)cells_x_ * cells_y_;
+  std::vector<double> cost(size, std::numeric_limits<double>::infinity());
+  std::vector<std::int64_t> parent(size, -1);
+  std::vector<bool> closed(size, false);
+
+  typedef std::pair<double, std::size_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  const std::size_t start_index = index(start.x, start.y);
+  const std::size_t goal_index = index(goal.x, goal.y);
+  cost[start_index] = 0;
+  open.emplace(octile(goal.x - start.x, goal.y - start.y), start_index);
+
+  int directions[8];
+  bool found = false;
+  while (!open.empty()) {
+    const std::size_t current = open.top().second;
+    open.pop();
+    if (closed[current]) continue;
+    closed[current] = true;
+    if (current == goal_index) {
+      found = true;
+      break;
+    }
+    if ((++expansions & 255u) == 0 &&
+        std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                      started)
+                .count() > max_time)
+      return false;
+
+    const int x = (int)(current % cells_x_), y = (int)(current / cells_x_);
+    int incoming = -1;
+    if (parent[current] >= 0) {
+      const auto p = (std::size_t)parent[current];
+      incoming = direction(sign(x - (int)(p % cells_x_)),
+                           sign(y - (int)(p / cells_x_)));
+    }
+    const int n = successorDirections(x, y, incoming, directions);
+    for (int i = 0; i < n; ++i) {
+      Cell successor;
+      const int d = directions[i];
+      if (hasJumpTable() ? !jumpTable(x, y, d, goal, successor)
+                         : !jump(x, y, DX[d], DY[d], goal, successor))
+        continue;
+      const std::size_t next = index(successor.x, successor.y);
+      if (closed[next]) continue;
+      const double next_cost =
+          cost[current] + octile(successor.x - x, successor.y - y);
+      if (next_cost < cost[next]) {
+        cost[next] = next_cost;
+        parent[next] = (std::int64_t)current;
+        open.emplace(
+            next_cost + octile(goal.x - successor.x, goal.y - successor.y),
+            next);
+      }
+    }
+  }
+  if (!found) return false;
+
+  // expand the jump points to neighboring vertices
+  std::vector<std::size_t> jump_points;
+  for (auto i = (std::int64_t)goal_index; i >= 0; i = parent[(std::size_t)i])
+    jump_points.push_back((std::size_t)i);
+  std::reverse(jump_points.begin(), jump_points.end());
+  path.emplace_back(start);
+  for (std::size_t i = 1; i < jump_points.size(); ++i) {
+    const int tx = (int)(jump_points[i] % cells_x_);
+    const int ty = (int)(jump_points[i] / cells_x_);
+    Cell c = path.back();
+    const int dx = sign(tx - c.x), dy = sign(ty - c.y);
+    while (c.x != tx || c.y != ty) {
+      c.x += dx;
+      c.y += dy;
+      path.push_back(c);
+    }
+  }
+  return true;
+}
+
+bool JumpPointGrid::lineOfSight(double x0, double y0, double x1,
+                                double y1) const {
+  // traverse the cells of the vertices, which span +-0.5 around them
+  int cx = (int)std::round(x0), cy = (int)std::round(y0);
+  if (!free(cx, cy)) return false;
+  const double dx = x1 - x0, dy = y1 - y0;
+  const int sx = dx > 0 ? 1 : -1, sy = dy > 0 ? 1 : -1;
+  const double inf = std::numeric_limits<double>::infinity();
+  const double delta_x = dx != 0 ? 1. / std::abs(dx) : inf;
+  const double delta_y = dy != 0 ? 1. / std::abs(dy) : inf;
+  double t_x = dx != 0 ? (cx + .5 * sx - x0) / dx : inf;
+  double t_y = dy != 0 ? (cy + .5 * sy - y0) / dy : inf;
+  const double eps = 1e-9;
+  while (std::min(t_x, t_y) < 1. - eps) {
+    if (t_x < t_y - eps) {
+      cx += sx;
+      t_x += delta_x;
+    } else if (t_y < t_x - eps) {
+      cy += sy;
+      t_y += delta_y;
+    } else {
+      // passing through a corner
+      if (!free(cx + sx, cy) || !free(cx, cy + sy)) return false;
+      cx += sx;
+      cy += sy;
+      t_x += delta_x;
+      t_y += delta_y;
+    }
+    if (!free(cx, cy)) return false;
+  }
+  return true;
+}
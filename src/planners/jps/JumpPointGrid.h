@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Environment;
+
+/**
+ * Occupancy grid over the environment on which Jump Point Search operates.
+ * The grid vertices are spaced by the unit of the environment and aligned
+ * with its origin, like the nodes of Theta*. A vertex is occupied if the
+ * robot at that position (with zero heading) is not valid.
+ *
+ * Diagonal moves are only allowed if both adjacent straight moves are free,
+ * i.e. paths never cut corners of obstacles.
+ *
+ * Optionally, the grid stores the JPS+ jump distances of every free vertex
+ * in the 8 directions. Grids are cached by the content hash of the
+ * environment and the collision settings, so that repeated runs on the same
+ * map rasterize it and compute the jump table only once.
+ */
+class JumpPointGrid {
+ public:
+  struct Cell {
+    int x{0}, y{0};
+    Cell() = default;
+    Cell(int x, int y) : x(x), y(y) {}
+    bool operator==(const Cell &c) const { return x == c.x && y == c.y; }
+  };
+
+  /**
+   * Returns the grid of the environment, computing it (and its jump table if
+   * jump_table is true) if it is not cached yet.
+   */
+  static std::shared_ptr<const JumpPointGrid> get(Environment &environment,
+                                                  bool jump_table);
+
+  /**
+   * Builds the grid from the occupancy of its vertices, stored row by row.
+   */
+  JumpPointGrid(double origin_x, double origin_y, double resolution,
+                int cells_x, int cells_y, std::vector<unsigned char> occupied,
+                bool jump_table);
+
+  /**
+   * A* search over jump points from start to goal. The resulting path
+   * contains every vertex from start to goal, such that consecutive vertices
+   * are neighbors. Stops after max_time seconds.
+   */
+  bool search(const Cell &start, const Cell &goal, std::vector<Cell> &path,
+              double max_time, unsigned int &expansions) const;
+
+  /**
+   * Checks if the straight line between the two positions, given in grid
+   * coordinates, only traverses free vertex cells. Lines that pass exactly
+   * through the corner of two cells require both adjacent cells to be free.
+   */
+  bool lineOfSight(double x0, double y0, double x1, double y1) const;
+
+  bool free(int x, int y) const {
+    return x >= 0 && y >= 0 && x < cells_x_ && y < cells_y_ &&
+           !occupied_[(std::size_t)y * cells_x_ + x];
+  }
+  bool free(const Cell &c) const { return free(c.x, c.y); }
+
+  /**
+   * Vertex closest to the position given in environment coordinates.
+   */
+  Cell cell(double x, double y) const;
+
+  double toGridX(double x) const { return (x - origin_x_) / resolution_; }
+  double toGridY(double y) const { return (y - origin_y_) / resolution_; }
+  double toWorldX(double x) const { return origin_x_ + x * resolution_; }
+  double toWorldY(double y) const { return origin_y_ + y * resolution_; }
+
+  double resolution() const { return resolution_; }
+  int cellsX() const { return cells_x_; }
+  int cellsY() const { return cells_y_; }
+  bool hasJumpTable() const { return !jumps_.empty(); }
+
+ private:
+  bool canMove(int x, int y, int dx, int dy) const {
+    return free(x + dx, y + dy) &&
+           (dx == 0 || dy == 0 || (free(x + dx, y) && free(x, y + dy)));
+  }
+
+  /**
+   * Whether a vertex reached by a straight move has a forced neighbor.
+   */
+  bool forced(int x, int y, int dx, int dy) const;
+
+  /**
+   * Directions from the vertex that remain after pruning the neighbors that
+   * can be reached at least as cheaply without passing through the vertex.
+   */
+  int successorDirections(int x, int y, int parent, int *directions) const;
+
+  /**
+   * Jumps from the vertex in the given direction without the jump table.
+   */
+  bool jump(int x, int y, int dx, int dy, const Cell &goal, Cell &result) const;
+
+  /**
+   * Looks up the next jump point in the given direction from the jump table,
+   * also stopping at the row or column of the goal.
+   */
+  bool jumpTable(int x, int y, int direction, const Cell &goal,
+                 Cell &result) const;
+
+  void computeJumpTable();
+
+  std::size_t index(int x, int y) const {
+    return (std::size_t)y * cells_x_ + x;
+  }
+
+  double origin_x_, origin_y_;
+  double resolution_;
+  int cells_x_, cells_y_;
+  std::vector<unsigned char> occupied_;
+
+  // per vertex and direction, the distance to the next jump point if
+  // positive, otherwise the negated number of free vertices until a wall
+  std::vector<std::int32_t> jumps_;
+};
@@ -0,0 +1,160 @@
+#include "planners/jps/JumpPointSearch.h"
+
+#include <cmath>
+
+#include "utils/PlannerUtils.hpp"
+#include "utils/Stopwatch.hpp"
+
+JumpPointSearch::JumpPointSearch()
+    : AbstractPlanner(name()), _solution(global::settings.ompl.space_info) {}
+
+ob::PlannerStatus JumpPointSearch::run() {
+  _solved = false;
+  _solution.clear();
+  _expansions = 0;
+  Stopwatch watch;
+  watch.start();
+
+  auto &environment = *global::settings.environment;
+  const auto grid =
+      JumpPointGrid::get(environment, global::settings.jps.jump_table);
+  const Point start = environment.start(), goal = environment.goal();
+  const auto start_cell = grid->cell(start.x, start.y);
+  const auto goal_cell = grid->cell(goal.x, goal.y);
+  if (!grid->free(start_cell)) {
+    _planningTime = watch.stop();
+    OMPL_ERROR("JPS: The start vertex is occupied.");
+    return ob::PlannerStatus::INVALID_START;
+  }
+  if (!grid->free(goal_cell)) {
+    _planningTime = watch.stop();
+    OMPL_ERROR("JPS: The goal vertex is occupied.");
+    return ob::PlannerStatus::INVALID_GOAL;
+  }
+
+  std::vector<JumpPointGrid::Cell> cells;
+  const bool found =
+      grid->search(start_cell, goal_cell, cells,
+                   global::settings.max_planning_time - watch.elapsed(),
+                   _expansions);
+  OMPL_DEBUG("JPS: Expanded %u jump points.", _expansions);
+  if (!found) {
+    _planningTime = watch.stop();
+    OMPL_WARN("JPS: No path found.");
+    return ob::PlannerStatus::TIMEOUT;
+  }
+
+  // the first and last vertex are replaced by the exact start and goal
+  std::vector<Point> points;
+  points.reserve(cells.size() + 1);
+  for (const auto &c : cells)
+    points.emplace_back(grid->toWorldX(c.x), grid->toWorldY(c.y));
+  if (points.size() < 2) points.emplace_back();
+  points.front() = start;
+  points.back() = goal;
+
+  std::vector<std::size_t> waypoints;
+  if (global::settings.jps.string_pulling) {
+    waypoints = pullString(*grid, points);
+  } else {
+    for (std::size_t i = 0; i < points.size(); ++i) waypoints.push_back(i);
+  }
+  // the grid path is free of collisions, but its steered connections may not
+  // be, in which case it is only reported as an approximate solution
+  bool collision_free;
+  if (global::settings.jps.steer_postprocessing) {
+    collision_free = repairSteering(points, waypoints);
+    _solution = toPath(points, waypoints);
+  } else {
+    _solution = toPath(points, waypoints);
+    collision_free = !collides(_solution);
+  }
+  _planningTime = watch.stop();
+  _solved = collision_free;
+  if (!collision_free) {
+    OMPL_WARN("JPS: The steered path collides with the environment.");
+    return ob::PlannerStatus::APPROXIMATE_SOLUTION;
+  }
+  return ob::PlannerStatus::EXACT_SOLUTION;
+}
+
+std::vector<std::size_t> JumpPointSearch::pullString(
+    const JumpPointGrid &grid, const std::vector<Point> &grid_path) const {
+  std::vector<std::size_t> waypoints{0};
+  std::size_t anchor = 0;
+  for (std::size_t i = 2; i < grid_path.size(); ++i) {
+    const auto &a = grid_path[anchor], &b = grid_path[i];
+    if (!grid.lineOfSight(grid.toGridX(a.x), grid.toGridY(a.y),
+                          grid.toGridX(b.x), grid.toGridY(b.y))) {
+      anchor = i - 1;
+      waypoints.push_back(anchor);
+    }
+  }
+  waypoints.push_back(grid_path.size() - 1);
+  return waypoints;
+}
+
+bool JumpPointSearch::repairSteering(
+    const std::vector<Point> &points,
+    std::vector<std::size_t> &waypoints) const {
+  std::vector<std::size_t> refined;
+  bool changed = true, collision_free = true;
+  while (changed) {
+    changed = false;
+    collision_free = true;
+    const auto path = toPath(points, waypoints);
+    const auto &states = path.getStates();
+    refined.clear();
+    for (std::size_t i = 0; i + 1 < waypoints.size(); ++i) {
+      refined.push_back(waypoints[i]);
+      if (!PlannerUtils::collides(states[i], states[i + 1])) continue;
+      if (waypoints[i + 1] - waypoints[i] > 1) {
+        refined.push_back((waypoints[i] + waypoints[i + 1]) / 2);
+        changed = true;
+      } else {
+        // neighboring vertices cannot be refined any further
+        collision_free = false;
+      }
+    }
+    refined.push_back(waypoints.back());
+    waypoints.swap(refined);
+  }
+  return collision_free;
+}
+
+bool JumpPointSearch::collides(const og::PathGeometric &path) const {
+  const auto &states = path.getStates();
+  for (std::size_t i = 0; i + 1 < states.size(); ++i) {
+    if (PlannerUtils::collides(states[i], states[i + 1])) return true;
+  }
+  return false;
+}
+
+og::PathGeometric JumpPointSearch::toPath(
+    const std::vector<Point> &points,
+    const std::vector<std::size_t> &waypoints) const {
+  og::PathGeometric path(global::settings.ompl.space_info);
+  auto *state = global::settings.ompl.state_space->allocState()->as<State>();
+  for (std::size_t i = 0; i < waypoints.size(); ++i) {
+    const auto &p = points[waypoints[i]];
+    double yaw;
+    if (i == 0) {
+      yaw = global::settings.environment->startTheta();
+    } else if (i + 1 == waypoints.size()) {
+      yaw = global::settings.environment->goalTheta();
+    } else {
+      // mean direction of the incoming and outgoing segments
+      const auto &prev = points[waypoints[i - 1]];
+      const auto &next = points[waypoints[i + 1]];
+      const double in = std::atan2(p.y - prev.y, p.x - prev.x);
+      const double out = std::atan2(next.y - p.y, next.x - p.x);
+      yaw = std::atan2(std::sin(in) + std::sin(out),
+                       std::cos(in) + std::cos(out));
+    }
+    state->setXY(p.x, p.y);
+    state->setYaw(yaw);
+    path.append(state);
+  }
+  global::settings.ompl.state_space->freeState(state);
+  return path;
+}
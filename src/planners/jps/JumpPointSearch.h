@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ompl/geometric/PathGeometric.h>
+
+#include "base/PlannerSettings.h"
+#include "planners/AbstractPlanner.h"
+#include "planners/jps/JumpPointGrid.h"
+
+namespace ob = ompl::base;
+namespace og = ompl::geometric;
+
+/**
+ * Jump Point Search on the grid of the environment, with optional JPS+ jump
+ * tables that are cached per map (see JumpPointGrid). The grid path is
+ * shortened by string pulling and, optionally, repaired where its segments
+ * collide when they are connected by the steer function. Paths whose steered
+ * segments still collide are reported as approximate solutions.
+ *
+ * Settings are found in global::settings.jps.
+ */
+class JumpPointSearch : public AbstractPlanner {
+ public:
+  JumpPointSearch();
+
+  std::string name() const override { return "JPS"; }
+
+  ob::PlannerStatus run() override;
+
+  og::PathGeometric solution() const override { return _solution; }
+
+  bool hasReachedGoalExactly() const override { return _solved; }
+  double planningTime() const override { return _planningTime; }
+
+  /**
+   * Number of jump points expanded by the last search.
+   */
+  unsigned int expansions() const { return _expansions; }
+
+  nlohmann::json getSettings() const override {
+    return {{"jump_table", global::settings.jps.jump_table.value()},
+            {"string_pulling", global::settings.jps.string_pulling.value()},
+            {"steer_postprocessing",
+             global::settings.jps.steer_postprocessing.value()}};
+  }
+
+ private:
+  /**
+   * Indices of the grid path vertices that remain after string pulling.
+   */
+  std::vector<std::size_t> pullString(
+      const JumpPointGrid &grid, const std::vector<Point> &grid_path) const;
+
+  /**
+   * Restores grid vertices between waypoints whose steered connection
+   * collides, until all segments are collision-free or consist of
+   * neighboring vertices.
+   * @return False if steered segments between neighboring vertices collide.
+   */
+  bool repairSteering(const std::vector<Point> &points,
+                      std::vector<std::size_t> &waypoints) const;
+
+  /**
+   * Whether any of the steered segments of the path collides.
+   */
+  bool collides(const og::PathGeometric &path) const;
+
+  og::PathGeometric toPath(const std::vector<Point> &points,
+                           const std::vector<std::size_t> &waypoints) const;
+
+  og::PathGeometric _solution;
+  bool _solved{false};
+  double _planningTime{0};
+  unsigned int _expansions{0};
+};
@@ -1,8 +1,12 @@
 #include "SbplPlanner.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utils/PlannerUtils.hpp>
 #include <utils/Stopwatch.hpp>
 
+#include "base/HeuristicTable.h"
+
 #define SAVE_SBPL_MAZE_IMAGE
 
 #ifdef SAVE_SBPL_MAZE_IMAGE
@@ -12,11 +16,83 @@
 #include <ctime>
 #endif
 
-template <sbpl::Planner PlannerT>
-SbplPlanner<PlannerT>::SbplPlanner()
-    : AbstractPlanner(name()),
-      _solution(og::PathGeometric(global::settings.ompl.space_info)) {
-  _env = new EnvironmentNAVXYTHETALAT;
+namespace {
+/**
+ * Cost map of the current environment at SBPL's resolution, one cost per
+ * cell in row-major order (20 for obstacles, 1 for free cells).
+ */
+struct SbplCostMap {
+  int cells_x{0};
+  int cells_y{0};
+  std::vector<unsigned char> costs;
+};
+
+SbplCostMap createSbplCostMap() {
+  SbplCostMap map;
+  map.cells_x = static_cast<int>(global::settings.environment->width() /
+                                 global::settings.sbpl.resolution /
+                                 global::settings.sbpl.scaling);
+  map.cells_y = static_cast<int>(global::settings.environment->height() /
+                                 global::settings.sbpl.resolution /
+                                 global::settings.sbpl.scaling);
+
+  std::cout << "Environment, W: " << global::settings.environment->width()
+            << ", H: " << global::settings.environment->height() << std::endl;
+  std::cout << "Environment, cells_x: " << map.cells_x
+            << ", cells_y: " << map.cells_y << std::endl;
+
+  double min_x = global::settings.environment->getBounds().low[0];
+  double min_y = global::settings.environment->getBounds().low[1];
+
+  // convert SBPL cell coordinates to environment coordinates
+  auto index2env = [&min_x, &min_y](int ix, int iy, double *x, double *y) {
+    *x = ix * global::settings.sbpl.resolution * global::settings.sbpl.scaling +
+         min_x;
+    *y = iy * global::settings.sbpl.resolution * global::settings.sbpl.scaling +
+         min_y;
+  };
+
+#ifdef SAVE_SBPL_MAZE_IMAGE
+  std::vector<unsigned char> maze_data(map.cells_x * map.cells_y);
+  // XXX flip maze image vertically to appear the same as the SVG
+  stbi_flip_vertically_on_write(1);
+#endif
+
+  map.costs.resize(map.cells_x * map.cells_y);
+  double env_x, env_y;
+  for (int ix = 0; ix < map.cells_x; ++ix) {
+    for (int iy = 0; iy < map.cells_y; ++iy) {
+      index2env(ix, iy, &env_x, &env_y);
+      const bool collides =
+          global::settings.environment->collides(env_x, env_y);
+      map.costs[iy * map.cells_x + ix] =
+          static_cast<unsigned char>(collides ? 20u : 1u);
+#ifdef SAVE_SBPL_MAZE_IMAGE
+      maze_data[iy * map.cells_x + ix] = collides ? 127u : 255u;
+#endif
+    }
+  }
+
+#ifdef SAVE_SBPL_MAZE_IMAGE
+  std::string maze_image_filename =
+      "sbpl_" + std::to_string(std::time(0)) + ".bmp";
+  if (!stbi_write_bmp(maze_image_filename.c_str(), map.cells_x, map.cells_y,
+                      1, maze_data.data())) {
+    OMPL_ERROR("Failed to save SBPL maze as Bitmap file.");
+  } else {
+    std::cout << "Saved SBPL maze at " << maze_image_filename << std::endl;
+  }
+#endif
+  return map;
+}
+
+/**
+ * Creates a new SBPL environment from the given cost map for the current
+ * robot shape and SBPL settings.
+ */
+std::shared_ptr<EnvironmentNAVXYTHETALAT> createSbplEnvironment(
+    const SbplCostMap &map) {
+  auto env = std::make_shared<EnvironmentNAVXYTHETALAT>();
 
   // define the robot shape
   vector<sbpl_2Dpt_t> perimeterptsV;
@@ -32,29 +108,15 @@ SbplPlanner<PlannerT>::SbplPlanner()
     }
   }
 
-  OMPL_DEBUG("Constructing %s Planner", name().c_str());
-
   std::cout << "SBPL motion primitive filename: "
             << global::settings.sbpl.motion_primitive_filename << std::endl;
 
-  const auto cells_x = static_cast<int>(global::settings.environment->width() /
-                                        global::settings.sbpl.resolution /
-                                        global::settings.sbpl.scaling);
-  const auto cells_y = static_cast<int>(global::settings.environment->height() /
-                                        global::settings.sbpl.resolution /
-                                        global::settings.sbpl.scaling);
-
-  std::cout << "Environment, W: " << global::settings.environment->width()
-            << ", H: " << global::settings.environment->height() << std::endl;
-  std::cout << "Environment, cells_x: " << cells_x << ", cells_y: " << cells_y
-            << std::endl;
-
   try {
-    _env->InitializeEnv(
-        cells_x, cells_y,
-        nullptr,  // mapdata
-        0, 0, 0,  // start (x, y, theta, t)
-        0, 0, 0,  // goal (x, y, theta)
+    env->InitializeEnv(
+        map.cells_x, map.cells_y,
+        map.costs.data(),  // mapdata
+        0, 0, 0,           // start (x, y, theta, t)
+        0, 0, 0,           // goal (x, y, theta)
         // goal tolerance
         global::settings.sbpl.goal_tolerance_x,
         global::settings.sbpl.goal_tolerance_y,
@@ -66,9 +128,92 @@ SbplPlanner<PlannerT>::SbplPlanner()
         global::settings.sbpl.motion_primitive_filename.value().c_str());
   } catch (...) {
     OMPL_ERROR("Error occurred while creating SBPL environment.");
-    delete _env;
     throw;
   }
+  std::cout << "Initialized " << map.cells_x << "x" << map.cells_y
+            << " SBPL environment.\n";
+  return env;
+}
+
+/**
+ * SBPL heuristic that estimates the cost-to-go of a state from the heuristic
+ * table of the map, converted to SBPL's cost unit (milliseconds of driving at
+ * the nominal forward velocity).
+ */
+class HeuristicTableSbplHeuristic : public Heuristic {
+ public:
+  HeuristicTableSbplHeuristic(EnvironmentNAVXYTHETALAT *environment,
+                              std::shared_ptr<const HeuristicTable> table)
+      : Heuristic(environment),
+        _environment(environment),
+        _table(std::move(table)) {}
+
+  int GetGoalHeuristic(int state_id) override {
+    int ix, iy, theta;
+    _environment->GetCoordFromState(state_id, ix, iy, theta);
+    const double cell_size =
+        global::settings.sbpl.resolution * global::settings.sbpl.scaling;
+    // SBPL places its states at the cell centers, and reaches the goal at
+    // the center of the goal cell, up to half a cell diagonal from the goal
+    const double x = (ix + .5) * cell_size +
+                     global::settings.environment->getBounds().low[0];
+    const double y = (iy + .5) * cell_size +
+                     global::settings.environment->getBounds().low[1];
+    const double distance =
+        std::max(0., _table->costToGo(x, y) - std::sqrt(.5) * cell_size) /
+        global::settings.sbpl.scaling;
+    return static_cast<int>(NAVXYTHETALAT_COSTMULT_MTOMM * distance /
+                            global::settings.sbpl.forward_velocity);
+  }
+
+  // the table only covers distances to the goal
+  int GetStartHeuristic(int /*state_id*/) override { return 0; }
+  int GetFromToHeuristic(int /*from_id*/, int /*to_id*/) override {
+    return 0;
+  }
+
+ private:
+  EnvironmentNAVXYTHETALAT *_environment;
+  std::shared_ptr<const HeuristicTable> _table;
+};
+
+/**
+ * Cost map of the map that has been planned on last. It is shared between
+ * planner instances, so that consecutive queries on the same map (e.g. Moving
+ * AI scenarios in batch mode) do not sample the environment again. Each
+ * planner still gets a fresh SBPL environment, since SBPL environments keep
+ * search state (e.g. the state ID mapping) that must not outlive a planner.
+ */
+struct SbplCostMapCache {
+  std::weak_ptr<Environment> environment;
+  double resolution{0};
+  double scaling{0};
+  SbplCostMap map;
+
+  const SbplCostMap &get() {
+    if (!map.costs.empty() &&
+        environment.lock() == global::settings.environment &&
+        resolution == global::settings.sbpl.resolution &&
+        scaling == global::settings.sbpl.scaling) {
+      OMPL_DEBUG("Reusing SBPL cost map of the current map.");
+      return map;
+    }
+    map = createSbplCostMap();
+    environment = global::settings.environment;
+    resolution = global::settings.sbpl.resolution;
+    scaling = global::settings.sbpl.scaling;
+    return map;
+  }
+} sbplCostMapCache;
+}  // namespace
+
+template <sbpl::Planner PlannerT>
+SbplPlanner<PlannerT>::SbplPlanner()
+    : AbstractPlanner(name()),
+      _solution(og::PathGeometric(global::settings.ompl.space_info)) {
+  OMPL_DEBUG("Constructing %s Planner", name().c_str());
+
+  _env = createSbplEnvironment(sbplCostMapCache.get());
 
   double min_x = global::settings.environment->getBounds().low[0];
   double min_y = global::settings.environment->getBounds().low[1];
@@ -76,13 +221,6 @@ SbplPlanner<PlannerT>::SbplPlanner()
   double max_x = global::settings.environment->getBounds().high[0];
   double max_y = global::settings.environment->getBounds().high[1];
 
-  // convert SBPL cell coordinates to environment coordinates
-  auto index2env = [&min_x, &min_y](int ix, int iy, double *x, double *y) {
-    *x = ix * global::settings.sbpl.resolution * global::settings.sbpl.scaling +
-         min_x;
-    *y = iy * global::settings.sbpl.resolution * global::settings.sbpl.scaling +
-         min_y;
-  };
   // convert environment coordinates to SBPL cell coordinates
   auto env2index = [&min_x, &min_y](double x, double y, int *ix,
                                                 int *iy) {
@@ -92,38 +230,6 @@ SbplPlanner<PlannerT>::SbplPlanner()
           global::settings.sbpl.scaling;
   };
 
-#ifdef SAVE_SBPL_MAZE_IMAGE
-  unsigned char maze_data[cells_x * cells_y];
-  // XXX flip maze image vertically to appear the same as the SVG
-  stbi_flip_vertically_on_write(1);
-#endif
-
-  double env_x, env_y;
-  for (int ix = 0; ix < cells_x; ++ix) {
-    for (int iy = 0; iy < cells_y; ++iy) {
-      index2env(ix, iy, &env_x, &env_y);
-      const bool collides =
-          global::settings.environment->collides(env_x, env_y);
-      _env->UpdateCost(ix, iy, static_cast<unsigned char>(collides ? 20u : 1u));
-#ifdef SAVE_SBPL_MAZE_IMAGE
-      maze_data[iy * cells_x + ix] = collides ? 127u : 255u;
-#endif
-    }
-  }
-  std::cout << "Initialized " << cells_x << "x" << cells_y
-            << " SBPL environment.\n";
-
-#ifdef SAVE_SBPL_MAZE_IMAGE
-  std::string maze_image_filename =
-      "sbpl_" + std::to_string(std::time(0)) + ".bmp";
-  if (!stbi_write_bmp(maze_image_filename.c_str(), cells_x, cells_y, 1,
-                      maze_data)) {
-    OMPL_ERROR("Failed to save SBPL maze as Bitmap file.");
-  } else {
-    std::cout << "Saved SBPL maze at " << maze_image_filename << std::endl;
-  }
-#endif
-
   // Initialize MDP Info
   MDPConfig MDPCfg{};
   if (!_env->InitializeMDPCfg(&MDPCfg)) {
@@ -132,23 +238,32 @@ SbplPlanner<PlannerT>::SbplPlanner()
 
   switch (PlannerT) {
     case sbpl::SBPL_ARASTAR:
-      _sbPlanner = new ARAPlanner(_env, ForwardSearch);
+      _sbPlanner = new ARAPlanner(_env.get(), ForwardSearch);
       break;
     case sbpl::SBPL_LAZY_ARA:
-      _sbPlanner = new LazyARAPlanner(_env, ForwardSearch);
+      _sbPlanner = new LazyARAPlanner(_env.get(), ForwardSearch);
       break;
     case sbpl::SBPL_ADSTAR:
-      _sbPlanner = new ADPlanner(_env, ForwardSearch);
+      _sbPlanner = new ADPlanner(_env.get(), ForwardSearch);
       break;
     case sbpl::SBPL_RSTAR:
-      _sbPlanner = new RSTARPlanner(_env, ForwardSearch);
+      _sbPlanner = new RSTARPlanner(_env.get(), ForwardSearch);
       break;
     case sbpl::SBPL_ANASTAR:
-      _sbPlanner = new anaPlanner(_env, ForwardSearch);
+      _sbPlanner = new anaPlanner(_env.get(), ForwardSearch);
       break;
     case sbpl::SBPL_MHA:
-      _heuristic = new EmbeddedHeuristic(_env);
-      _sbPlanner = new MHAPlanner(_env, _heuristic, nullptr, 0);
+      _heuristic = new EmbeddedHeuristic(_env.get());
+      if (global::settings.env.heuristic.sbpl_mha) {
+        _tableHeuristic = new HeuristicTableSbplHeuristic(
+            _env.get(),
+            HeuristicTable::get(*global::settings.environment,
+                                global::settings.environment->goal()));
+        _sbPlanner = new MHAPlanner(_env.get(), _heuristic, &_tableHeuristic,
+                                    1);
+      } else {
+        _sbPlanner = new MHAPlanner(_env.get(), _heuristic, nullptr, 0);
+      }
       break;
     default:
       throw SBPL_Exception("ERROR: This SBPL planner is not supported.");
@@ -236,8 +351,8 @@ SbplPlanner<PlannerT>::SbplPlanner()
 template <sbpl::Planner PlannerT>
 SbplPlanner<PlannerT>::~SbplPlanner() {
   delete _sbPlanner;
-  delete _env;
   delete _heuristic;
+  delete _tableHeuristic;
 }
 
 template <sbpl::Planner PlannerT>
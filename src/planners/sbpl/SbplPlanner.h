@@ -2,6 +2,8 @@
 
 #include <sbpl/headers.h>
 
+#include <memory>
+
 #include "planners/AbstractPlanner.h"
 
 namespace ob = ompl::base;
@@ -35,6 +37,12 @@ class SbplPlanner : public AbstractPlanner {
 
   ob::PlannerStatus run() override;
 
+  /**
+   * Start and goal are set on the SBPL environment and heuristics during
+   * construction, hence SBPL planners are always reconstructed.
+   */
+  bool reset(Environment &environment) override { return false; }
+
   og::PathGeometric solution() const override;
 
   bool hasReachedGoalExactly() const override;
@@ -42,8 +50,10 @@ class SbplPlanner : public AbstractPlanner {
 
  private:
   SBPLPlanner *_sbPlanner{nullptr};
-  EnvironmentNAVXYTHETALAT *_env{nullptr};
+  std::shared_ptr<EnvironmentNAVXYTHETALAT> _env;
   og::PathGeometric _solution;
   double _planningTime{0};
   EmbeddedHeuristic *_heuristic{nullptr};
+  // additional MHA* heuristic based on the HeuristicTable of the map
+  Heuristic *_tableHeuristic{nullptr};
 };
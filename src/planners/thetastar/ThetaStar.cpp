@@ -4,6 +4,8 @@
 #include <utils/PlannerUtils.hpp>
 #include <utils/Stopwatch.hpp>
 
+#include "base/HeuristicTable.h"
+
 #include "ThetaStar.h"
 
 #define DEBUG_LISTS 0
@@ -68,6 +70,18 @@ bool ThetaStar::search(std::vector<std::vector<GNode> > &paths, GNode start,
 
   if (USE_GRANDPARENT) thetastarsearch.use_connectGrandParent();
 
+  if (global::settings.thetaStar.lazy) thetastarsearch.useLazy();
+
+  if (global::settings.env.heuristic.theta_star) {
+    const double unit = global::settings.environment->unit();
+    const auto table = HeuristicTable::get(
+        *global::settings.environment,
+        Point(goal.x_r * unit, goal.y_r * unit));
+    thetastarsearch.SetHeuristic([table, unit](const GNode &node) {
+      return (float)(table->costToGo(node.x * unit, node.y * unit) / unit);
+    });
+  }
+
   _steps = 0;
 
   const unsigned int NumSearches = 1;
@@ -219,6 +233,9 @@ bool ThetaStar::search(std::vector<std::vector<GNode> > &paths, GNode start,
 
     // Display the number of loops the search went through
     OMPL_DEBUG("Theta* steps: %d ", (int)_steps);
+    OMPL_DEBUG("Theta* line-of-sight checks: %d computed, %d memoised",
+               (int)thetastarsearch.GetLineOfSightChecks(),
+               (int)thetastarsearch.GetLineOfSightHits());
 
     SearchCount++;
 
@@ -414,6 +414,8 @@ class GNode : public GNode_base {
     double th = this->theta;
     int parent_x = -1;
     int parent_y = -1;
+    // Lazy Theta* checks the line of sight once a successor is expanded
+    const bool lazy = thetastarsearch->IsLazy();
 
     if (parent_node) {
       parent_x = parent_node->x;
@@ -435,7 +437,8 @@ class GNode : public GNode_base {
     auto *pr1 = new GNode(x - 1, y, 1.0 * M_PI);
     pr1->CHECK_SUCCESSOR = 1;
     th1->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th1, pr1) && !((parent_x == x - 1) && (parent_y == y))) {
+    if ((lazy || thetastarsearch->LineOfSight(*th1, *pr1)) &&
+        !((parent_x == x - 1) && (parent_y == y))) {
       cnt_successors++;
       NewNode = GNode(x - 1, y, pr1->theta);
       NewNode.steer_cost = pr1->steer_cost;
@@ -450,7 +453,8 @@ class GNode : public GNode_base {
 
     pr2->CHECK_SUCCESSOR = 1;
     th2->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th2, pr2) && !((parent_x == x) && (parent_y == y - 1))) {
+    if ((lazy || thetastarsearch->LineOfSight(*th2, *pr2)) &&
+        !((parent_x == x) && (parent_y == y - 1))) {
       cnt_successors++;
       NewNode = GNode(x, y - 1, pr2->theta);
       NewNode.steer_cost = pr2->steer_cost;
@@ -466,7 +470,8 @@ class GNode : public GNode_base {
 
     pr3->CHECK_SUCCESSOR = 1;
     th3->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th3, pr3) && !((parent_x == x + 1) && (parent_y == y))) {
+    if ((lazy || thetastarsearch->LineOfSight(*th3, *pr3)) &&
+        !((parent_x == x + 1) && (parent_y == y))) {
       cnt_successors++;
       NewNode = GNode(x + 1, y, pr3->theta);
       NewNode.steer_cost = pr3->steer_cost;
@@ -482,7 +487,7 @@ class GNode : public GNode_base {
 
     pr4->CHECK_SUCCESSOR = 1;
     th4->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th4, pr4) &&
+    if ((lazy || thetastarsearch->LineOfSight(*th4, *pr4)) &&
         !((parent_x == x + 1) && (parent_y == y + 1))) {
       cnt_successors++;
       NewNode = GNode(x + 1, y + 1, pr4->theta);
@@ -499,7 +504,7 @@ class GNode : public GNode_base {
 
     pr5->CHECK_SUCCESSOR = 1;
     th5->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th5, pr5) &&
+    if ((lazy || thetastarsearch->LineOfSight(*th5, *pr5)) &&
         !((parent_x == x - 1) && (parent_y == y - 1))) {
       cnt_successors++;
 
@@ -517,7 +522,7 @@ class GNode : public GNode_base {
 
     pr6->CHECK_SUCCESSOR = 1;
     th6->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th6, pr6) &&
+    if ((lazy || thetastarsearch->LineOfSight(*th6, *pr6)) &&
         !((parent_x == x + 1) && (parent_y == y - 1))) {
       cnt_successors++;
 
@@ -535,7 +540,7 @@ class GNode : public GNode_base {
 
     pr7->CHECK_SUCCESSOR = 1;
     th7->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th7, pr7) &&
+    if ((lazy || thetastarsearch->LineOfSight(*th7, *pr7)) &&
         !((parent_x == x - 1) && (parent_y == y + 1))) {
       cnt_successors++;
 
@@ -553,7 +558,8 @@ class GNode : public GNode_base {
 
     pr8->CHECK_SUCCESSOR = 1;
     th8->CHECK_SUCCESSOR = 1;
-    if (lineofsight(th8, pr8) && !((parent_x == x) && (parent_y == y + 1))) {
+    if ((lazy || thetastarsearch->LineOfSight(*th8, *pr8)) &&
+        !((parent_x == x) && (parent_y == y + 1))) {
       cnt_successors++;
 
       NewNode = GNode(x, y + 1, pr8->theta);
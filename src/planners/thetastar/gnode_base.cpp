@@ -49,8 +49,18 @@ bool GNode_base::line(const GNode_base *parent_node,
 //    y1 = successor->y;
 //    bool c = ::line(x0, y0, y1, x1);
 
-  bool c =
-      !PlannerUtils::collides(parent_node->toState(), successor->toState());
+  if (auto *grid = PlannerUtils::lineOfSightGrid()) {
+    const double unit = global::settings.environment->unit();
+    return grid->thickLineOfSight(parent_node->x_r * unit,
+                                  parent_node->y_r * unit,
+                                  successor->x_r * unit, successor->y_r * unit);
+  }
+
+  auto *a = parent_node->toState();
+  auto *b = successor->toState();
+  bool c = !PlannerUtils::collides(a, b);
+  global::settings.ompl.state_space->freeState(a);
+  global::settings.ompl.state_space->freeState(b);
 //  OMPL_DEBUG("Line [%.2f %.2f %.2f] -- [%.2f %.2f %.2f] ?  %s",
 //             parent_node->x_r, parent_node->y_r, parent_node->theta,
 //             successor->x_r, successor->y_r, successor->theta,
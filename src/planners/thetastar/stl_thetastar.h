@@ -37,7 +37,11 @@ DAMAGE.
 // stl includes
 #include <algorithm>
 #include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <unistd.h>
@@ -69,6 +73,7 @@ class ThetaStarSearch {
   bool m_euclideanCost;
   bool m_useAstar;
   bool m_connectGrandParent;
+  bool m_lazy{false};
   // A node represents a possible state in the search
   // The user provided state type is included inside this type
 
@@ -145,12 +150,47 @@ class ThetaStarSearch {
 
   virtual void use_connectGrandParent() { m_connectGrandParent = true; }
 
+  // Use Lazy Theta*, which assumes line of sight while generating successors
+  // and only checks it once a node is expanded
+  virtual void useLazy() { m_lazy = true; }
+
+  bool IsLazy() const { return m_lazy; }
+
+  // Line-of-sight check between two user states whose results are memoised
+  // for the current search
+  bool LineOfSight(UserState &from, UserState &to) {
+    const LineOfSightKey key{{from.x_r, from.y_r, from.theta},
+                             {to.x_r, to.y_r, to.theta}};
+    const auto it = m_LineOfSightMemo.find(key);
+    if (it != m_LineOfSightMemo.end()) {
+      m_LineOfSightHits++;
+      return it->second;
+    }
+    const bool result = from.lineofsight(&from, &to);
+    m_LineOfSightMemo.emplace(key, result);
+    return result;
+  }
+
+  // Number of line-of-sight checks that were computed and that were answered
+  // from the memo during the current search
+  std::size_t GetLineOfSightChecks() const { return m_LineOfSightMemo.size(); }
+  std::size_t GetLineOfSightHits() const { return m_LineOfSightHits; }
+
   // call at any time to cancel the search and free up all the memory
   virtual void CancelSearch() { m_CancelRequest = true; }
 
+  // Set a heuristic that replaces the user state's GoalDistanceEstimate
+  // whenever it is larger
+  virtual void SetHeuristic(std::function<float(const UserState &)> h) {
+    m_Heuristic = std::move(h);
+  }
+
   // Set Start and goal states
   virtual void SetStartAndGoalStates(UserState &Start, UserState &Goal) {
     m_CancelRequest = false;
+    m_LineOfSightMemo.clear();
+    m_LineOfSightHits = 0;
+    m_ClosedCells.clear();
 
     m_Start = AllocateNode();
     m_Goal = AllocateNode();
@@ -166,7 +206,7 @@ class ThetaStarSearch {
     // The user only needs fill out the state information
 
     m_Start->g = 0;
-    m_Start->h = m_Start->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+    m_Start->h = GoalDistanceEstimate(m_Start->m_UserState);
     m_Start->f = m_Start->g + m_Start->h;
     m_Start->parent = m_Start;  // fix it.
 
@@ -211,6 +251,13 @@ class ThetaStarSearch {
     pop_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
     m_OpenList.pop_back();
 
+    // Lazy Theta* checks the line of sight to the parent only now and drops
+    // the node if no closed neighbor can reach it
+    if (m_lazy && n != m_Start && !SetVertex(n)) {
+      FreeNode(n);
+      return m_State;
+    }
+
     // Check for the goal, once we pop that we're done
     if (n->m_UserState.IsGoal(m_Goal->m_UserState)) {
       // The user is going to use the Goal Node he passed in
@@ -220,8 +267,7 @@ class ThetaStarSearch {
 
       //            OMPL_DEBUG("Setting Goal orientation..");
 
-      if (!(n->m_UserState.lineofsight(&(n->parent->m_UserState),
-                                       &((m_Goal)->m_UserState)))) {
+      if (!LineOfSight(n->parent->m_UserState, m_Goal->m_UserState)) {
         (m_Goal)->m_UserState.setOrientation(&(n->parent->m_UserState));
       }
 
@@ -270,10 +316,11 @@ class ThetaStarSearch {
       return m_State;
     } else  // not goal
     {
-      typename vector<Node *>::iterator closedlist_result;
       typename vector<Node *>::iterator openlist_result;
 
       m_ClosedList.push_back(n);
+      m_ClosedCells.emplace(CellKey(n->m_UserState.x, n->m_UserState.y),
+                            m_ClosedList.size() - 1);
 
       // We now need to generate the successors of this node
       // The user helps us to do this, and we keep the new nodes in
@@ -293,6 +340,10 @@ class ThetaStarSearch {
         if (n == nullptr) break;
         pop_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
         m_OpenList.pop_back();
+        if (m_lazy && !SetVertex(n)) {
+          FreeNode(n);
+          continue;
+        }
         ret = n->m_UserState.GetSuccessors(
             this, n->parent ? &n->parent->m_UserState : nullptr);
       }
@@ -319,15 +370,8 @@ class ThetaStarSearch {
       for (typename vector<Node *>::iterator successor = m_Successors.begin();
            successor != m_Successors.end(); successor++) {
         /// if successor is not in closed
-        for (closedlist_result = m_ClosedList.begin();
-             closedlist_result != m_ClosedList.end(); closedlist_result++) {
-          if ((*closedlist_result)
-                  ->m_UserState.IsSameState((*successor)->m_UserState)) {
-            break;
-          }
-        }
-
-        if (closedlist_result != m_ClosedList.end()) {
+        if (m_ClosedCells.count(CellKey((*successor)->m_UserState.x,
+                                        (*successor)->m_UserState.y)) > 0) {
           // we found this state on closed
           // consider the next successor now
           continue;
@@ -368,8 +412,7 @@ class ThetaStarSearch {
     double tcost = 0;
 
     if (n->parent != nullptr &&
-        n->m_UserState.lineofsight(&(n->parent->m_UserState),
-                                   &((successor)->m_UserState)) &&
+        AssumeLineOfSight(n->parent->m_UserState, successor->m_UserState) &&
         !m_useAstar) {
       if (m_euclideanCost)
         tcost = n->parent->g +
@@ -394,8 +437,7 @@ class ThetaStarSearch {
         }
 
         // Update cost and Parent
-        double h_succ =
-            (successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+        double h_succ = GoalDistanceEstimate((successor)->m_UserState);
 
         (successor)->parent = n->parent;
         (successor)->yaw = (successor)->m_UserState.theta;
@@ -450,8 +492,7 @@ class ThetaStarSearch {
           cout << endl;
         }
 
-        double h_succ =
-            (successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+        double h_succ = GoalDistanceEstimate((successor)->m_UserState);
         (successor)->parent = n;
         (successor)->g = newg;
         (successor)->h = (float)h_succ;
@@ -494,8 +535,8 @@ class ThetaStarSearch {
     double tcost = 0;
 
     if (n->parent->parent != nullptr &&
-        n->m_UserState.lineofsight(&(n->parent->parent->m_UserState),
-                                   &((successor)->m_UserState)) &&
+        AssumeLineOfSight(n->parent->parent->m_UserState,
+                          successor->m_UserState) &&
         !m_useAstar) {
       if (m_euclideanCost)
         tcost = n->parent->parent->g + n->parent->parent->m_UserState.GetCost(
@@ -519,8 +560,7 @@ class ThetaStarSearch {
         }
 
         // Update cost and Parent
-        double h_succ =
-            (successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+        double h_succ = GoalDistanceEstimate((successor)->m_UserState);
 
         (successor)->parent = n->parent->parent;
         (successor)->yaw = (successor)->m_UserState.theta;
@@ -553,8 +593,8 @@ class ThetaStarSearch {
         push_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
       }
     } else if (n->parent != nullptr &&
-               n->m_UserState.lineofsight(&(n->parent->m_UserState),
-                                          &((successor)->m_UserState)) &&
+               AssumeLineOfSight(n->parent->m_UserState,
+                                 successor->m_UserState) &&
                !m_useAstar) {
       if (m_euclideanCost)
         tcost = n->parent->g +
@@ -579,8 +619,7 @@ class ThetaStarSearch {
         }
 
         // Update cost and Parent
-        double h_succ =
-            (successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+        double h_succ = GoalDistanceEstimate((successor)->m_UserState);
 
         (successor)->parent = n->parent;
         (successor)->yaw = (successor)->m_UserState.theta;
@@ -636,8 +675,7 @@ class ThetaStarSearch {
           cout << endl;
         }
 
-        double h_succ =
-            (successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
+        double h_succ = GoalDistanceEstimate((successor)->m_UserState);
         (successor)->parent = n;
         (successor)->g = newg;
         (successor)->h = (float)h_succ;
@@ -877,6 +915,7 @@ class ThetaStarSearch {
     }
 
     m_ClosedList.clear();
+    m_ClosedCells.clear();
 
     // delete the goal
 
@@ -912,6 +951,7 @@ class ThetaStarSearch {
     }
 
     m_ClosedList.clear();
+    m_ClosedCells.clear();
   }
 
   // Node memory management
@@ -927,12 +967,70 @@ class ThetaStarSearch {
   }
 
  private:
+  // Lazy Theta* defers line-of-sight checks until the node is expanded
+  bool AssumeLineOfSight(UserState &from, UserState &to) {
+    return m_lazy || LineOfSight(from, to);
+  }
+
+  // Lazy Theta*: ensures that the expanded node is in line of sight of its
+  // parent, otherwise connects it to the adjacent closed node through which
+  // it is reached the cheapest
+  bool SetVertex(Node *n) {
+    if (n->parent != nullptr &&
+        LineOfSight(n->parent->m_UserState, n->m_UserState))
+      return true;
+
+    Node *best = nullptr;
+    float best_g = FLT_MAX;
+    // ties are broken by the closing order
+    std::size_t best_index = 0;
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        if (dx == 0 && dy == 0) continue;
+        const auto range = m_ClosedCells.equal_range(
+            CellKey(n->m_UserState.x + dx, n->m_UserState.y + dy));
+        for (auto it = range.first; it != range.second; ++it) {
+          Node *closed = m_ClosedList[it->second];
+          UserState &state = closed->m_UserState;
+          const float g =
+              closed->g + (m_euclideanCost ? state.GetCost(n->m_UserState)
+                                           : state.GetCostTraj(n->m_UserState));
+          if ((g < best_g || (g == best_g && it->second < best_index)) &&
+              LineOfSight(state, n->m_UserState)) {
+            best = closed;
+            best_g = g;
+            best_index = it->second;
+          }
+        }
+      }
+    }
+    if (best == nullptr) return false;
+
+    n->parent = best;
+    n->g = best_g;
+    n->f = best_g + n->h;
+    return true;
+  }
+
+  float GoalDistanceEstimate(UserState &state) {
+    const float h = state.GoalDistanceEstimate(m_Goal->m_UserState);
+    if (!m_Heuristic) return h;
+    return std::max(h, m_Heuristic(state));
+  }
+
   // Heap using std:vector
   vector<Node *> m_OpenList;
 
   // Closed list is a std::vector.
   vector<Node *> m_ClosedList;
 
+  // Indices in the closed list by cell, to find closed states and neighbors
+  // without scanning the closed list
+  static std::uint64_t CellKey(int x, int y) {
+    return (std::uint64_t)(std::uint32_t)x << 32 | (std::uint32_t)y;
+  }
+  std::unordered_multimap<std::uint64_t, std::size_t> m_ClosedCells;
+
   // Contains the successors of the current node evaluated during the search
   vector<Node *> m_Successors;
 
@@ -956,4 +1054,25 @@ class ThetaStarSearch {
   int m_AllocateNodeCount;
 
   bool m_CancelRequest;
+
+  std::function<float(const UserState &)> m_Heuristic;
+
+  struct LineOfSightKey {
+    double from[3], to[3];
+    bool operator==(const LineOfSightKey &k) const {
+      return std::equal(from, from + 3, k.from) && std::equal(to, to + 3, k.to);
+    }
+  };
+  struct LineOfSightKeyHash {
+    std::size_t operator()(const LineOfSightKey &k) const {
+      std::size_t h = 0;
+      for (const double v : k.from) h = h * 31 + std::hash<double>()(v);
+      for (const double v : k.to) h = h * 31 + std::hash<double>()(v);
+      return h;
+    }
+  };
+
+  std::unordered_map<LineOfSightKey, bool, LineOfSightKeyHash>
+      m_LineOfSightMemo;
+  std::size_t m_LineOfSightHits{0};
 };
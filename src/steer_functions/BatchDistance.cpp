@@ -0,0 +1,512 @@
+#include "steer_functions/BatchDistance.h"
+
+#include <ompl/base/spaces/SE2StateSpace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace ob = ompl::base;
+
+namespace {
+// Width of the GCC / Clang vector types below, which the compiler lowers to
+// AVX, SSE2 or NEON instructions (or to scalar code on other targets).
+#if defined(__AVX__)
+constexpr std::size_t LaneBytes = 32;
+#else
+constexpr std::size_t LaneBytes = 16;
+#endif
+constexpr std::size_t LaneCount = LaneBytes / sizeof(double);
+
+// same tolerances as ompl::base::DubinsStateSpace
+constexpr double DubinsEps = 1e-6;
+constexpr double DubinsZero = -1e-7;
+// same tolerance as ompl::base::ReedsSheppStateSpace
+constexpr double ReedsSheppZero = 10. * std::numeric_limits<double>::epsilon();
+constexpr double TwoPi = 2. * M_PI;
+constexpr double HalfPi = .5 * M_PI;
+constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+/**
+ * Branch-free math on all lanes of a register. Comparisons yield masks with
+ * all bits set in the lanes where they hold, which select() uses to blend
+ * two registers. The transcendental functions are accurate to a few ulp on
+ * the arguments the steer functions produce.
+ */
+namespace simd {
+typedef double Vec __attribute__((vector_size(LaneBytes)));
+typedef std::int64_t Mask __attribute__((vector_size(LaneBytes)));
+
+inline Vec splat(double x) { return Vec{} + x; }
+
+inline Vec load(const double *p) {
+  Vec v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline void store(double *p, Vec v) { std::memcpy(p, &v, sizeof(v)); }
+
+inline Mask lt(Vec a, Vec b) { return (Mask)(a < b); }
+inline Mask le(Vec a, Vec b) { return (Mask)(a <= b); }
+
+inline Vec select(Mask mask, Vec a, Vec b) {
+  return (Vec)((mask & (Mask)a) | (~mask & (Mask)b));
+}
+
+inline Vec min(Vec a, Vec b) { return select(lt(a, b), a, b); }
+inline Vec max(Vec a, Vec b) { return select(lt(a, b), b, a); }
+
+inline Vec abs(Vec x) {
+  return (Vec)((Mask)x & (Mask{} + std::numeric_limits<std::int64_t>::max()));
+}
+
+/**
+ * Lanes whose sign bit is set, including -0.
+ */
+inline Mask signbit(Vec x) { return (Mask)((Mask)x < 0); }
+
+/**
+ * Vectorized by the compiler as long as sqrt does not need to set errno
+ * (see -fno-math-errno in CMakeLists.txt).
+ */
+inline Vec sqrt(Vec x) {
+  Vec r;
+  for (std::size_t i = 0; i < LaneCount; ++i) r[i] = std::sqrt(x[i]);
+  return r;
+}
+
+/**
+ * Rounds to the nearest integer for |x| < 2^51 by adding and subtracting
+ * 1.5 * 2^52, at which magnitude doubles have no fractional bits.
+ */
+inline Vec round(Vec x) {
+  constexpr double Magic = 6755399441055744.;
+  return (x + Magic) - Magic;
+}
+
+inline Vec floor(Vec x) {
+  const Vec r = round(x);
+  return r - select(lt(x, r), splat(1.), splat(0.));
+}
+
+inline Vec trunc(Vec x) {
+  const Vec r = floor(abs(x));
+  return select(signbit(x), -r, r);
+}
+
+inline void sincos(Vec x, Vec &s, Vec &c) {
+  // Cody-Waite reduction by multiples of pi / 2 in two parts
+  constexpr double HalfPiHigh = 1.57079632673412561417;
+  constexpr double HalfPiLow = 6.07710050650619224932e-11;
+  const Vec q = round(x * (2. / M_PI));
+  const Vec r = (x - q * HalfPiHigh) - q * HalfPiLow;
+  const Vec r2 = r * r;
+  // coefficients of r^(2i + 1) and r^(2i) in the Taylor series on
+  // |r| <= pi / 4
+  static constexpr double SinSeries[] = {
+      1., -1. / 6., 1. / 120., -1. / 5040., 1. / 362880., -1. / 39916800.,
+      1. / 6227020800., -1. / 1307674368000., 1. / 355687428096000.};
+  static constexpr double CosSeries[] = {
+      1., -1. / 2., 1. / 24., -1. / 720., 1. / 40320., -1. / 3628800.,
+      1. / 479001600., -1. / 87178291200., 1. / 20922789888000.};
+  Vec ps = splat(0.), pc = splat(0.);
+  for (int i = 8; i >= 0; --i) {
+    ps = SinSeries[i] + r2 * ps;
+    pc = CosSeries[i] + r2 * pc;
+  }
+  ps *= r;
+  // quadrant 0..3 of x
+  const Vec k = q - 4. * floor(q * .25);
+  const Mask odd = (Mask)(k == 1.) | (Mask)(k == 3.);
+  const Vec sin = select(odd, pc, ps), cos = select(odd, ps, pc);
+  s = select((Mask)(k >= 2.), -sin, sin);
+  c = select((Mask)(k == 1.) | (Mask)(k == 2.), -cos, cos);
+}
+
+inline Vec atan2(Vec y, Vec x) {
+  constexpr double Tan15 = .26794919243112270;
+  constexpr double InvSqrt3 = .57735026918962576;
+  const Vec ax = abs(x), ay = abs(y);
+  const Vec big = max(ax, ay), small = min(ax, ay);
+  // ratio in [0, 1], zero if both arguments are zero
+  const Vec a = small / select((Mask)(big > 0.), big, splat(1.));
+  // atan(a) = pi / 6 + atan((a - 1 / sqrt(3)) / (1 + a / sqrt(3)))
+  const Mask reduce = lt(splat(Tan15), a);
+  const Vec t = select(reduce, (a - InvSqrt3) / (1. + a * InvSqrt3), a);
+  const Vec t2 = t * t;
+  // Taylor series on |t| <= tan(pi / 12)
+  Vec p = splat(-1. / 27.);
+  for (int i = 12; i >= 0; --i) p = (i % 2 ? -1. : 1.) / (2 * i + 1) + t2 * p;
+  Vec r = t * p + select(reduce, splat(M_PI / 6.), splat(0.));
+  r = select(lt(ax, ay), HalfPi - r, r);
+  r = select(signbit(x), M_PI - r, r);
+  return select(signbit(y), -r, r);
+}
+
+inline Vec acos(Vec x) {
+  return atan2(sqrt(max((1. - x) * (1. + x), splat(0.))), x);
+}
+
+inline Vec asin(Vec x) {
+  return atan2(x, sqrt(max((1. - x) * (1. + x), splat(0.))));
+}
+}  // namespace simd
+
+using simd::Mask;
+using simd::Vec;
+using simd::select;
+using simd::splat;
+
+/**
+ * Structure-of-arrays copy of a block of SE(2) states. The lanes after the
+ * last state repeat the last state, so that full registers can be loaded.
+ */
+struct Block {
+  static constexpr std::size_t Size = BatchDistance::BlockSize;
+  static_assert(Size % LaneCount == 0, "Blocks must fill whole registers.");
+
+  double x[Size];
+  double y[Size];
+  double yaw[Size];
+
+  void gather(const ob::State *const *xs, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto *s = xs[i]->as<ob::SE2StateSpace::StateType>();
+      x[i] = s->getX();
+      y[i] = s->getY();
+      yaw[i] = s->getYaw();
+    }
+    for (std::size_t i = n; i % LaneCount != 0; ++i) {
+      x[i] = x[n - 1];
+      y[i] = y[n - 1];
+      yaw[i] = yaw[n - 1];
+    }
+  }
+};
+
+/**
+ * Evaluates kernel(dx, dy, yaw) on the offsets of the states xs from q and
+ * their headings, LaneCount states at a time.
+ */
+template <typename Kernel>
+void forEachBlock(const ob::State *q, const ob::State *const *xs,
+                  double *out, std::size_t n, Kernel kernel) {
+  const auto *qs = q->as<ob::SE2StateSpace::StateType>();
+  const double qx = qs->getX(), qy = qs->getY();
+  Block block;
+  double result[Block::Size];
+  for (std::size_t offset = 0; offset < n; offset += Block::Size) {
+    const std::size_t m = std::min(Block::Size, n - offset);
+    block.gather(xs + offset, m);
+    for (std::size_t i = 0; i < m; i += LaneCount) {
+      simd::store(result + i,
+                  kernel(simd::load(block.x + i) - qx,
+                         simd::load(block.y + i) - qy,
+                         simd::load(block.yaw + i)));
+    }
+    std::copy(result, result + m, out + offset);
+  }
+}
+
+inline Vec dubinsMod2pi(Vec x) {
+  Vec xm = x - TwoPi * simd::floor(x * (1. / TwoPi));
+  // snap values close to a full turn (and tiny negative inputs) to zero
+  xm = select(simd::lt(TwoPi - xm, splat(.5 * DubinsEps)), splat(0.), xm);
+  return select(simd::lt(x, splat(0.)) & simd::lt(splat(DubinsZero), x),
+                splat(0.), xm);
+}
+
+/**
+ * Length of the shortest Dubins path for unit turning radius in the
+ * normalized form of ompl::base::DubinsStateSpace::dubins(), infeasible
+ * words have infinite length.
+ */
+inline Vec dubinsLength(Vec d, Vec alpha, Vec beta) {
+  using namespace simd;
+  Vec sa, ca, sb, cb;
+  sincos(alpha, sa, ca);
+  sincos(beta, sb, cb);
+  const Vec cab = ca * cb + sa * sb;
+  const Vec zero = splat(DubinsZero), inf = splat(Infinity);
+
+  // LSL
+  const Vec lsl_tmp = 2. + d * d - 2. * (cab - d * (sa - sb));
+  const Vec lsl_theta = atan2(cb - ca, d + sa - sb);
+  const Vec lsl = select(le(zero, lsl_tmp),
+                         dubinsMod2pi(-alpha + lsl_theta) +
+                             sqrt(max(lsl_tmp, splat(0.))) +
+                             dubinsMod2pi(beta - lsl_theta),
+                         inf);
+
+  // RSR
+  const Vec rsr_tmp = 2. + d * d - 2. * (cab - d * (sb - sa));
+  const Vec rsr_theta = atan2(ca - cb, d - sa + sb);
+  const Vec rsr = select(le(zero, rsr_tmp),
+                         dubinsMod2pi(alpha - rsr_theta) +
+                             sqrt(max(rsr_tmp, splat(0.))) +
+                             dubinsMod2pi(-beta + rsr_theta),
+                         inf);
+
+  // RSL
+  const Vec rsl_tmp = d * d - 2. + 2. * (cab - d * (sa + sb));
+  const Vec rsl_p = sqrt(max(rsl_tmp, splat(0.)));
+  const Vec rsl_theta = atan2(ca + cb, d - sa - sb) - atan2(splat(2.), rsl_p);
+  const Vec rsl = select(le(zero, rsl_tmp),
+                         dubinsMod2pi(alpha - rsl_theta) + rsl_p +
+                             dubinsMod2pi(beta - rsl_theta),
+                         inf);
+
+  // LSR
+  const Vec lsr_tmp = -2. + d * d + 2. * (cab + d * (sa + sb));
+  const Vec lsr_p = sqrt(max(lsr_tmp, splat(0.)));
+  const Vec lsr_theta =
+      atan2(-ca - cb, d + sa + sb) - atan2(splat(-2.), lsr_p);
+  const Vec lsr = select(le(zero, lsr_tmp),
+                         dubinsMod2pi(-alpha + lsr_theta) + lsr_p +
+                             dubinsMod2pi(-dubinsMod2pi(beta) + lsr_theta),
+                         inf);
+
+  // RLR
+  const Vec rlr_tmp = .125 * (6. - d * d + 2. * (cab + d * (sa - sb)));
+  const Vec rlr_p =
+      TwoPi - acos(max(splat(-1.), min(splat(1.), rlr_tmp)));
+  const Vec rlr_theta = atan2(ca - cb, d - sa + sb);
+  const Vec rlr_t = dubinsMod2pi(alpha - rlr_theta + .5 * rlr_p);
+  const Vec rlr =
+      select(lt(abs(rlr_tmp), splat(1.)),
+             rlr_t + rlr_p + dubinsMod2pi(alpha - beta - rlr_t + rlr_p), inf);
+
+  // LRL
+  const Vec lrl_tmp = .125 * (6. - d * d + 2. * (cab - d * (sa - sb)));
+  const Vec lrl_p =
+      TwoPi - acos(max(splat(-1.), min(splat(1.), lrl_tmp)));
+  const Vec lrl_theta = atan2(-ca + cb, d + sa - sb);
+  const Vec lrl_t = dubinsMod2pi(-alpha + lrl_theta + .5 * lrl_p);
+  const Vec lrl =
+      select(lt(abs(lrl_tmp), splat(1.)),
+             lrl_t + lrl_p + dubinsMod2pi(beta - alpha - lrl_t + lrl_p), inf);
+
+  const Vec length =
+      min(min(min(lsl, rsr), min(rsl, lsr)), min(rlr, lrl));
+  // coincident states
+  return select(lt(d, splat(DubinsEps)) &
+                    lt(abs(alpha - beta), splat(DubinsEps)),
+                d, length);
+}
+
+/**
+ * Wraps to [-pi, pi] like the fmod-based mod2pi of
+ * ompl::base::ReedsSheppStateSpace.
+ */
+inline Vec reedsSheppMod2pi(Vec x) {
+  const Vec v = x - TwoPi * simd::trunc(x * (1. / TwoPi));
+  return select(simd::lt(v, splat(-M_PI)), v + TwoPi,
+                select(simd::lt(splat(M_PI), v), v - TwoPi, v));
+}
+
+/**
+ * Goal pose relative to the start pose in units of the turning radius.
+ */
+struct Pose {
+  Vec x, y, phi, sin_phi, cos_phi;
+};
+
+/**
+ * Word lengths for unit turning radius, following the formulas (8.1) to
+ * (8.11) of Reeds and Shepp as implemented by ReedsSheppStateSpace.
+ * Infeasible words have infinite length.
+ */
+namespace words {
+using namespace simd;
+
+inline Mask nonNegative(Vec x) { return le(splat(-ReedsSheppZero), x); }
+inline Mask nonPositive(Vec x) { return le(x, splat(ReedsSheppZero)); }
+
+inline Vec length(Mask valid, Vec length) {
+  return select(valid, length, splat(Infinity));
+}
+
+inline void tauOmega(Vec u, Vec v, Vec xi, Vec eta, Vec phi, Vec &tau,
+                     Vec &omega) {
+  const Vec delta = reedsSheppMod2pi(u - v);
+  Vec su, cu, sd, cd, sv, cv;
+  sincos(u, su, cu);
+  sincos(delta, sd, cd);
+  sincos(v, sv, cv);
+  const Vec A = su - sd, B = cu - cd - 1.;
+  const Vec t1 = atan2(eta * A - xi * B, xi * A + eta * B);
+  const Vec t2 = 2. * (cd - cv - cu) + 3.;
+  tau = reedsSheppMod2pi(select(lt(t2, splat(0.)), t1 + M_PI, t1));
+  omega = reedsSheppMod2pi(tau - u + v - phi);
+}
+
+// (8.1)
+inline Vec LpSpLp(const Pose &p) {
+  const Vec xi = p.x - p.sin_phi, eta = p.y - 1. + p.cos_phi;
+  const Vec u = sqrt(xi * xi + eta * eta), t = atan2(eta, xi);
+  const Vec v = reedsSheppMod2pi(p.phi - t);
+  return length(nonNegative(t) & nonNegative(v), abs(t) + u + abs(v));
+}
+
+// (8.2)
+inline Vec LpSpRp(const Pose &p) {
+  const Vec xi = p.x + p.sin_phi, eta = p.y - 1. - p.cos_phi;
+  const Vec u1 = xi * xi + eta * eta;
+  const Vec u = sqrt(max(u1 - 4., splat(0.)));
+  const Vec t = reedsSheppMod2pi(atan2(eta, xi) + atan2(splat(2.), u));
+  const Vec v = reedsSheppMod2pi(t - p.phi);
+  return length(le(splat(4.), u1) & nonNegative(t) & nonNegative(v),
+                abs(t) + u + abs(v));
+}
+
+// (8.3), (8.4)
+inline Vec LpRmL(const Pose &p) {
+  const Vec xi = p.x - p.sin_phi, eta = p.y - 1. + p.cos_phi;
+  const Vec u1 = sqrt(xi * xi + eta * eta);
+  const Vec u = -2. * asin(min(.25 * u1, splat(1.)));
+  const Vec t = reedsSheppMod2pi(atan2(eta, xi) + .5 * u + M_PI);
+  const Vec v = reedsSheppMod2pi(p.phi - t + u);
+  return length(le(u1, splat(4.)) & nonNegative(t) & nonPositive(u),
+                abs(t) + abs(u) + abs(v));
+}
+
+// (8.7)
+inline Vec LpRupLumRm(const Pose &p) {
+  const Vec xi = p.x + p.sin_phi, eta = p.y - 1. - p.cos_phi;
+  const Vec rho = .25 * (2. + sqrt(xi * xi + eta * eta));
+  const Vec u = acos(min(rho, splat(1.)));
+  Vec t, v;
+  tauOmega(u, -u, xi, eta, p.phi, t, v);
+  return length(le(rho, splat(1.)) & nonNegative(t) & nonPositive(v),
+                abs(t) + 2. * abs(u) + abs(v));
+}
+
+// (8.8)
+inline Vec LpRumLumRp(const Pose &p) {
+  const Vec xi = p.x + p.sin_phi, eta = p.y - 1. - p.cos_phi;
+  const Vec rho = (20. - xi * xi - eta * eta) / 16.;
+  const Vec u = -acos(max(min(rho, splat(1.)), splat(0.)));
+  Vec t, v;
+  tauOmega(u, u, xi, eta, p.phi, t, v);
+  return length(le(splat(0.), rho) & le(rho, splat(1.)) &
+                    le(splat(-HalfPi), u) & nonNegative(t) & nonNegative(v),
+                abs(t) + 2. * abs(u) + abs(v));
+}
+
+// (8.9)
+inline Vec LpRmSmLm(const Pose &p) {
+  const Vec xi = p.x - p.sin_phi, eta = p.y - 1. + p.cos_phi;
+  const Vec rho = sqrt(xi * xi + eta * eta);
+  const Vec r = sqrt(max(rho * rho - 4., splat(0.)));
+  const Vec u = 2. - r;
+  const Vec t = reedsSheppMod2pi(atan2(eta, xi) + atan2(r, splat(-2.)));
+  const Vec v = reedsSheppMod2pi(p.phi - HalfPi - t);
+  return length(le(splat(2.), rho) & nonNegative(t) & nonPositive(u) &
+                    nonPositive(v),
+                abs(t) + abs(u) + abs(v) + HalfPi);
+}
+
+// (8.10)
+inline Vec LpRmSmRm(const Pose &p) {
+  const Vec xi = p.x + p.sin_phi, eta = p.y - 1. - p.cos_phi;
+  const Vec rho = sqrt(xi * xi + eta * eta);
+  const Vec t = atan2(xi, -eta);
+  const Vec u = 2. - rho;
+  const Vec v = reedsSheppMod2pi(t + HalfPi - p.phi);
+  return length(le(splat(2.), rho) & nonNegative(t) & nonPositive(u) &
+                    nonPositive(v),
+                abs(t) + abs(u) + abs(v) + HalfPi);
+}
+
+// (8.11)
+inline Vec LpRmSLmRp(const Pose &p) {
+  const Vec xi = p.x + p.sin_phi, eta = p.y - 1. - p.cos_phi;
+  const Vec rho = sqrt(xi * xi + eta * eta);
+  const Vec u = 4. - sqrt(max(rho * rho - 4., splat(0.)));
+  const Vec t = reedsSheppMod2pi(
+      atan2((4. - u) * xi - 2. * eta, -2. * xi + (u - 4.) * eta));
+  const Vec v = reedsSheppMod2pi(t - p.phi);
+  return length(le(splat(2.), rho) & nonPositive(u) & nonNegative(t) &
+                    nonNegative(v),
+                abs(t) + abs(u) + abs(v) + M_PI);
+}
+
+/**
+ * Shortest length of the word and its time-flipped, reflected and
+ * time-flipped reflected variants, which all have the same length as the
+ * word on the transformed pose.
+ */
+template <typename Word>
+inline Vec symmetric(Word word, const Pose &p) {
+  const Pose timeflip{-p.x, p.y, -p.phi, -p.sin_phi, p.cos_phi};
+  const Pose reflect{p.x, -p.y, -p.phi, -p.sin_phi, p.cos_phi};
+  const Pose both{-p.x, -p.y, p.phi, p.sin_phi, p.cos_phi};
+  return min(min(word(p), word(timeflip)), min(word(reflect), word(both)));
+}
+}  // namespace words
+
+inline Vec reedsSheppLength(const Pose &p) {
+  using namespace words;
+  // the backwards words solve the path from the goal to the start
+  const Pose backwards{p.x * p.cos_phi + p.y * p.sin_phi,
+                       p.x * p.sin_phi - p.y * p.cos_phi, p.phi, p.sin_phi,
+                       p.cos_phi};
+  const Vec csc = simd::min(symmetric(LpSpLp, p), symmetric(LpSpRp, p));
+  const Vec ccc =
+      simd::min(symmetric(LpRmL, p), symmetric(LpRmL, backwards));
+  const Vec cccc =
+      simd::min(symmetric(LpRupLumRm, p), symmetric(LpRumLumRp, p));
+  const Vec ccsc = simd::min(
+      simd::min(symmetric(LpRmSmLm, p), symmetric(LpRmSmRm, p)),
+      simd::min(symmetric(LpRmSmLm, backwards),
+                symmetric(LpRmSmRm, backwards)));
+  const Vec ccscc = symmetric(LpRmSLmRp, p);
+  return simd::min(simd::min(simd::min(csc, ccc), simd::min(cccc, ccsc)),
+                   ccscc);
+}
+}  // namespace
+
+const std::size_t BatchDistance::Lanes = LaneCount;
+
+void BatchDistance::se2(const ob::State *q, const ob::State *const *xs,
+                        double *out, std::size_t n, double position_weight,
+                        double heading_weight) {
+  const double qyaw = q->as<ob::SE2StateSpace::StateType>()->getYaw();
+  forEachBlock(q, xs, out, n, [&](Vec dx, Vec dy, Vec yaw) {
+    // headings are normalized to [-pi, pi)
+    Vec dyaw = simd::abs(yaw - qyaw);
+    dyaw = select(simd::lt(splat(M_PI), dyaw), TwoPi - dyaw, dyaw);
+    return position_weight * simd::sqrt(dx * dx + dy * dy) +
+           heading_weight * dyaw;
+  });
+}
+
+void BatchDistance::dubins(const ob::State *q, const ob::State *const *xs,
+                           double *out, std::size_t n,
+                           double turning_radius) {
+  const double qyaw = q->as<ob::SE2StateSpace::StateType>()->getYaw();
+  const double inv_radius = 1. / turning_radius;
+  forEachBlock(q, xs, out, n, [&](Vec dx, Vec dy, Vec yaw) {
+    const Vec d = simd::sqrt(dx * dx + dy * dy) * inv_radius;
+    const Vec th = simd::atan2(dy, dx);
+    return turning_radius * dubinsLength(d, dubinsMod2pi(qyaw - th),
+                                         dubinsMod2pi(yaw - th));
+  });
+}
+
+void BatchDistance::reedsShepp(const ob::State *q,
+                               const ob::State *const *xs, double *out,
+                               std::size_t n, double turning_radius) {
+  const double qyaw = q->as<ob::SE2StateSpace::StateType>()->getYaw();
+  const double inv_radius = 1. / turning_radius;
+  const double c = std::cos(qyaw) * inv_radius;
+  const double s = std::sin(qyaw) * inv_radius;
+  forEachBlock(q, xs, out, n, [&](Vec dx, Vec dy, Vec yaw) {
+    Pose pose{c * dx + s * dy, -s * dx + c * dy, yaw - qyaw, Vec{}, Vec{}};
+    simd::sincos(pose.phi, pose.sin_phi, pose.cos_phi);
+    return turning_radius * reedsSheppLength(pose);
+  });
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ompl/base/State.h>
+
+#include <cstddef>
+
+/**
+ * Interface of state spaces that compute the distances from one state to many
+ * states at once. Planners evaluate distances mostly in this pattern (nearest
+ * neighbor queries, k-nearest connection strategies), which allows the steer
+ * function to be evaluated over contiguous arrays instead of one state pair at
+ * a time. The SE(2), Dubins and Reeds-Shepp kernels evaluate several states
+ * per SIMD register (see Lanes): every word of the steer function is solved
+ * in all lanes without branches, infeasible words are masked out and the
+ * shortest feasible word is selected per lane.
+ */
+class BatchDistance {
+ public:
+  virtual ~BatchDistance() = default;
+
+  /**
+   * Computes out[i] = distance(q, xs[i]) for i < n. The distances may be
+   * approximated (see SteerDistanceTable), so they must only be used to rank
+   * nearest neighbor candidates, not as motion costs.
+   */
+  virtual void distanceMany(const ompl::base::State *q,
+                            const ompl::base::State *const *xs, double *out,
+                            std::size_t n) const = 0;
+
+  /**
+   * Number of states the kernels gather into structure-of-arrays buffers at
+   * a time.
+   */
+  static constexpr std::size_t BlockSize = 64;
+
+  /**
+   * Number of states evaluated per SIMD register (four with AVX, two with
+   * SSE2 or NEON).
+   */
+  static const std::size_t Lanes;
+
+  /**
+   * Batch distance of the SE(2) state space, i.e. the weighted sum of the
+   * Euclidean distance and the heading difference.
+   */
+  static void se2(const ompl::base::State *q,
+                  const ompl::base::State *const *xs, double *out,
+                  std::size_t n, double position_weight,
+                  double heading_weight);
+
+  /**
+   * Batch distance of the Dubins state space for the given turning radius,
+   * which matches ompl::base::DubinsStateSpace::distance() up to rounding.
+   */
+  static void dubins(const ompl::base::State *q,
+                     const ompl::base::State *const *xs, double *out,
+                     std::size_t n, double turning_radius);
+
+  /**
+   * Batch distance of the Reeds-Shepp state space for the given turning
+   * radius, which matches ompl::base::ReedsSheppStateSpace::distance() up to
+   * rounding. All 44 candidate words (the CSC, CCC, CCCC, CCSC and CCSCC
+   * families with their time-flipped, reflected and backwards variants) are
+   * evaluated in every lane.
+   */
+  static void reedsShepp(const ompl::base::State *q,
+                         const ompl::base::State *const *xs, double *out,
+                         std::size_t n, double turning_radius);
+};
@@ -0,0 +1,225 @@
+#include "steer_functions/SteerDistanceTable.h"
+
+#include <ompl/base/ScopedState.h>
+#include <ompl/base/spaces/DubinsStateSpace.h>
+#include <ompl/base/spaces/ReedsSheppStateSpace.h>
+#include <ompl/util/Console.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+namespace ob = ompl::base;
+
+namespace {
+const char Magic[8] = {'M', 'P', 'B', 'S', 'D', 'T', '0', '1'};
+
+ob::StateSpacePtr unitRadiusSpace(Steering::SteeringType type) {
+  if (type == Steering::STEER_TYPE_DUBINS)
+    return std::make_shared<ob::DubinsStateSpace>(1.);
+  return std::make_shared<ob::ReedsSheppStateSpace>(1.);
+}
+}  // namespace
+
+SteerDistanceTable::SteerDistanceTable(Steering::SteeringType type,
+                                       double extent, unsigned int cells_xy,
+                                       unsigned int cells_theta,
+                                       double max_cell_spread)
+    : type_(type),
+      extent_(extent),
+      cells_xy_(std::max(2u, cells_xy)),
+      cells_theta_(std::max(1u, cells_theta)),
+      max_cell_spread_(max_cell_spread),
+      space_(unitRadiusSpace(type)) {
+  step_xy_ = 2. * extent_ / (cells_xy_ - 1);
+  step_theta_ = 2. * M_PI / cells_theta_;
+}
+
+std::shared_ptr<const SteerDistanceTable> SteerDistanceTable::loadOrGenerate(
+    Steering::SteeringType type, double extent, unsigned int cells_xy,
+    unsigned int cells_theta, double max_cell_spread,
+    const std::string &cache_dir) {
+  typedef std::tuple<int, double, unsigned int, unsigned int, double> Key;
+  static std::map<Key, std::shared_ptr<const SteerDistanceTable>> tables;
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  const Key key{(int)type, extent, cells_xy, cells_theta, max_cell_spread};
+  const auto it = tables.find(key);
+  if (it != tables.end()) return it->second;
+
+  auto table = std::make_shared<SteerDistanceTable>(
+      type, extent, cells_xy, cells_theta, max_cell_spread);
+  const auto filename =
+      (boost::filesystem::path(cache_dir) / table->filename()).string();
+  if (table->load(filename)) {
+    OMPL_INFORM("Loaded %s distance table from %s.",
+                Steering::to_string(type).c_str(), filename.c_str());
+  } else {
+    OMPL_INFORM("Generating %s distance table with %u x %u x %u entries...",
+                Steering::to_string(type).c_str(), table->cells_xy_,
+                table->cells_xy_, table->cells_theta_);
+    table->generate();
+    boost::system::error_code error;
+    boost::filesystem::create_directories(cache_dir, error);
+    if (table->save(filename))
+      OMPL_INFORM("Saved distance table to %s.", filename.c_str());
+    else
+      OMPL_WARN("Could not save distance table to %s.", filename.c_str());
+  }
+  OMPL_INFORM("%.2f%% of the distance table cells use the exact solver.",
+              table->invalidCellRatio() * 100.);
+  tables[key] = table;
+  return table;
+}
+
+double SteerDistanceTable::exact(double x, double y, double theta) const {
+  ob::ScopedState<ob::SE2StateSpace> from(space_), to(space_);
+  from->setXY(0, 0);
+  from->setYaw(0);
+  to->setXY(x, y);
+  to->setYaw(theta);
+  return space_->distance(from.get(), to.get());
+}
+
+void SteerDistanceTable::generate() {
+  values_.resize((std::size_t)cells_xy_ * cells_xy_ * cells_theta_);
+  for (unsigned int k = 0; k < cells_theta_; ++k) {
+    const double theta = -M_PI + k * step_theta_;
+    for (unsigned int j = 0; j < cells_xy_; ++j) {
+      const double y = -extent_ + j * step_xy_;
+      for (unsigned int i = 0; i < cells_xy_; ++i) {
+        const double x = -extent_ + i * step_xy_;
+        values_[index(i, j, k)] = (float)exact(x, y, theta);
+      }
+    }
+  }
+  classifyCells();
+}
+
+void SteerDistanceTable::classifyCells() {
+  valid_.assign(values_.size(), false);
+  for (unsigned int k = 0; k < cells_theta_; ++k) {
+    const unsigned int k1 = (k + 1) % cells_theta_;
+    for (unsigned int j = 0; j + 1 < cells_xy_; ++j) {
+      for (unsigned int i = 0; i + 1 < cells_xy_; ++i) {
+        const float corners[8] = {
+            values_[index(i, j, k)],      values_[index(i + 1, j, k)],
+            values_[index(i, j + 1, k)],  values_[index(i + 1, j + 1, k)],
+            values_[index(i, j, k1)],     values_[index(i + 1, j, k1)],
+            values_[index(i, j + 1, k1)], values_[index(i + 1, j + 1, k1)]};
+        const auto range = std::minmax_element(corners, corners + 8);
+        valid_[index(i, j, k)] =
+            *range.second - *range.first <= max_cell_spread_;
+      }
+    }
+  }
+}
+
+double SteerDistanceTable::invalidCellRatio() const {
+  const std::size_t cells =
+      (std::size_t)(cells_xy_ - 1) * (cells_xy_ - 1) * cells_theta_;
+  std::size_t invalid = 0;
+  for (unsigned int k = 0; k < cells_theta_; ++k)
+    for (unsigned int j = 0; j + 1 < cells_xy_; ++j)
+      for (unsigned int i = 0; i + 1 < cells_xy_; ++i)
+        invalid += !valid_[index(i, j, k)];
+  return (double)invalid / cells;
+}
+
+double SteerDistanceTable::lookup(double x, double y, double theta) const {
+  const double fx = (x + extent_) / step_xy_;
+  const double fy = (y + extent_) / step_xy_;
+  if (!(fx >= 0 && fy >= 0 && fx < cells_xy_ - 1 && fy < cells_xy_ - 1))
+    return -1;
+  const auto i = (unsigned int)fx;
+  const auto j = (unsigned int)fy;
+
+  double ft = (theta + M_PI) / step_theta_;
+  ft -= std::floor(ft / cells_theta_) * cells_theta_;
+  const auto k = std::min((unsigned int)ft, cells_theta_ - 1);
+  if (!valid_[index(i, j, k)]) return -1;
+  const unsigned int k1 = (k + 1) % cells_theta_;
+
+  const double tx = fx - i, ty = fy - j, tt = ft - k;
+  const auto lerp = [](double a, double b, double t) {
+    return a + (b - a) * t;
+  };
+  const auto bilinear = [&](unsigned int kk) {
+    return lerp(
+        lerp(values_[index(i, j, kk)], values_[index(i + 1, j, kk)], tx),
+        lerp(values_[index(i, j + 1, kk)], values_[index(i + 1, j + 1, kk)],
+             tx),
+        ty);
+  };
+  return lerp(bilinear(k), bilinear(k1), tt);
+}
+
+double SteerDistanceTable::distance(const ob::State *from,
+                                    const ob::State *to,
+                                    double turning_radius) const {
+  const auto *s1 = from->as<ob::SE2StateSpace::StateType>();
+  const auto *s2 = to->as<ob::SE2StateSpace::StateType>();
+  // pose of the target in the frame of the source, in turning radii
+  const double dx = (s2->getX() - s1->getX()) / turning_radius;
+  const double dy = (s2->getY() - s1->getY()) / turning_radius;
+  const double c = std::cos(s1->getYaw()), s = std::sin(s1->getYaw());
+  const double d = lookup(c * dx + s * dy, -s * dx + c * dy,
+                          s2->getYaw() - s1->getYaw());
+  return d < 0 ? d : d * turning_radius;
+}
+
+std::string SteerDistanceTable::filename() const {
+  std::stringstream ss;
+  ss << (type_ == Steering::STEER_TYPE_DUBINS ? "dubins" : "reeds_shepp")
+     << "_e" << extent_ << "_" << cells_xy_ << "x" << cells_xy_ << "x"
+     << cells_theta_ << ".bin";
+  return ss.str();
+}
+
+bool SteerDistanceTable::save(const std::string &filename) const {
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) return false;
+  const int type = type_;
+  file.write(Magic, sizeof(Magic));
+  file.write(reinterpret_cast<const char *>(&type), sizeof(type));
+  file.write(reinterpret_cast<const char *>(&extent_), sizeof(extent_));
+  file.write(reinterpret_cast<const char *>(&cells_xy_), sizeof(cells_xy_));
+  file.write(reinterpret_cast<const char *>(&cells_theta_),
+             sizeof(cells_theta_));
+  file.write(reinterpret_cast<const char *>(values_.data()),
+             values_.size() * sizeof(float));
+  return file.good();
+}
+
+bool SteerDistanceTable::load(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return false;
+  char magic[sizeof(Magic)];
+  int type;
+  double extent;
+  unsigned int cells_xy, cells_theta;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&type), sizeof(type));
+  file.read(reinterpret_cast<char *>(&extent), sizeof(extent));
+  file.read(reinterpret_cast<char *>(&cells_xy), sizeof(cells_xy));
+  file.read(reinterpret_cast<char *>(&cells_theta), sizeof(cells_theta));
+  if (!file || std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+      type != type_ || extent != extent_ || cells_xy != cells_xy_ ||
+      cells_theta != cells_theta_)
+    return false;
+  values_.resize((std::size_t)cells_xy_ * cells_xy_ * cells_theta_);
+  file.read(reinterpret_cast<char *>(values_.data()),
+            values_.size() * sizeof(float));
+  if (!file) {
+    values_.clear();
+    return false;
+  }
+  classifyCells();
+  return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ompl/base/StateSpace.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "steer_functions/Steering.h"
+
+/**
+ * Lookup table of Reeds-Shepp or Dubins distances for a unit turning radius.
+ *
+ * Both distances only depend on the pose of the target relative to the
+ * source, normalized by the turning radius. The table samples this relative
+ * pose (dx, dy, dtheta) on a regular grid and interpolates trilinearly. Cells
+ * whose corner values differ by more than the allowed spread (e.g. at the
+ * discontinuities of the Dubins distance), and poses outside the table, are
+ * reported as invalid so that the exact distance is computed instead.
+ */
+class SteerDistanceTable {
+ public:
+  /**
+   * @param type Either STEER_TYPE_REEDS_SHEPP or STEER_TYPE_DUBINS.
+   * @param extent Half width of the table in x and y in turning radii.
+   * @param cells_xy Number of samples along x and y.
+   * @param cells_theta Number of samples along the heading.
+   * @param max_cell_spread Largest difference between the corner values of a
+   * cell (in turning radii) for which interpolation is used.
+   */
+  SteerDistanceTable(Steering::SteeringType type, double extent,
+                     unsigned int cells_xy, unsigned int cells_theta,
+                     double max_cell_spread);
+
+  /**
+   * Loads the table from the cache directory, or generates it with the
+   * analytic solver and stores it there. Tables are also kept in memory, so
+   * that subsequent requests with the same parameters return the same table.
+   */
+  static std::shared_ptr<const SteerDistanceTable> loadOrGenerate(
+      Steering::SteeringType type, double extent, unsigned int cells_xy,
+      unsigned int cells_theta, double max_cell_spread,
+      const std::string &cache_dir);
+
+  /**
+   * Interpolated distance for unit turning radius between the origin facing
+   * along the x-axis and the given pose.
+   * @return The distance, or a negative value if it has to be computed
+   * exactly.
+   */
+  double lookup(double x, double y, double theta) const;
+
+  /**
+   * Interpolated distance between two SE(2) states for the given turning
+   * radius, or a negative value if it has to be computed exactly.
+   */
+  double distance(const ompl::base::State *from, const ompl::base::State *to,
+                  double turning_radius) const;
+
+  /**
+   * Exact distance for unit turning radius computed by the analytic solver.
+   */
+  double exact(double x, double y, double theta) const;
+
+  /**
+   * Samples all grid points with the analytic solver.
+   */
+  void generate();
+
+  bool save(const std::string &filename) const;
+  bool load(const std::string &filename);
+
+  /**
+   * File name of this table inside the cache directory.
+   */
+  std::string filename() const;
+
+  Steering::SteeringType type() const { return type_; }
+  double extent() const { return extent_; }
+  unsigned int cellsXY() const { return cells_xy_; }
+  unsigned int cellsTheta() const { return cells_theta_; }
+
+  /**
+   * Ratio of table cells that fall back to the exact solver.
+   */
+  double invalidCellRatio() const;
+
+ private:
+  std::size_t index(unsigned int i, unsigned int j, unsigned int k) const {
+    return ((std::size_t)k * cells_xy_ + j) * cells_xy_ + i;
+  }
+
+  /**
+   * Determines which cells can be interpolated.
+   */
+  void classifyCells();
+
+  Steering::SteeringType type_;
+  double extent_;
+  unsigned int cells_xy_;
+  unsigned int cells_theta_;
+  double max_cell_spread_;
+  double step_xy_;
+  double step_theta_;
+  // analytic solver for unit turning radius
+  ompl::base::StateSpacePtr space_;
+
+  std::vector<float> values_;
+  // one entry per cell with the lower-left-front corner at the same index
+  std::vector<bool> valid_;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/**
+ * Incremental 64-bit FNV-1a hash that identifies environments, settings and
+ * derived data in caches and file names.
+ */
+class ContentHash {
+ public:
+  ContentHash &add(const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash_ ^= bytes[i];
+      hash_ *= 1099511628211ull;
+    }
+    return *this;
+  }
+
+  ContentHash &add(const std::string &text) {
+    return add(text.data(), text.size());
+  }
+
+  /**
+   * Adds the bytes of a value without indirections, e.g. a number.
+   */
+  template <typename T>
+  ContentHash &add(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only values without indirections can be hashed bytewise");
+    return add(&value, sizeof(T));
+  }
+
+  std::uint64_t value() const { return hash_; }
+
+ private:
+  std::uint64_t hash_{14695981039346656037ull};
+};
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 
 #include "smoothers/grips/GRIPS.h"
+#include "utils/TrajectoryCompression.h"
 
 nlohmann::json Log::_json = {{"runs", nlohmann::json::array()}};
 nlohmann::json Log::_currentRun;
@@ -122,4 +123,9 @@ std::vector<std::array<double, 3>> Log::serializeTrajectory(
     }
   }
   return r;
-}
\ No newline at end of file
+}
+
+nlohmann::json Log::logTrajectory(const ompl::geometric::PathGeometric &traj,
+                                  bool interpolate) {
+  return TrajectoryCompression::encode(serializeTrajectory(traj, interpolate));
+}
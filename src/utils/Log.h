@@ -28,6 +28,13 @@ class Log {
   static std::vector<std::array<double, 3>> serializeTrajectory(
       const ompl::control::PathControl &traj, bool interpolate = true);
 
+  /**
+   * Serializes the trajectory as it is written to the log, i.e. encoded by
+   * TrajectoryCompression if benchmark.trajectory_compression is enabled.
+   */
+  static nlohmann::json logTrajectory(
+      const ompl::geometric::PathGeometric &traj, bool interpolate = true);
+
  private:
   static nlohmann::json _json;
   static nlohmann::json _currentRun;
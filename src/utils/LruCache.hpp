@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <mutex>
+
+/**
+ * Thread-safe cache that keeps the most recently used values, e.g. data
+ * derived from an environment that is shared between runs. Values are looked
+ * up by predicates, so that they can be matched by several properties.
+ */
+template <typename T>
+class LruCache {
+ public:
+  /**
+   * Copies the most recently used value that fulfills the predicate to value
+   * and marks it as used.
+   * @return False if no value fulfills the predicate.
+   */
+  template <typename Predicate>
+  bool find(const Predicate &predicate, T &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = values_.begin(); it != values_.end(); ++it) {
+      if (!predicate(*it)) continue;
+      values_.splice(values_.begin(), values_, it);
+      value = values_.front();
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Removes all values that fulfill the predicate.
+   */
+  template <typename Predicate>
+  void remove(const Predicate &predicate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_.remove_if(predicate);
+  }
+
+  /**
+   * Inserts the value as the most recently used one, replacing the values
+   * that fulfill the predicate, and drops the least recently used values
+   * beyond the capacity (at least the new value is kept).
+   */
+  template <typename Predicate>
+  void insert(const T &value, std::size_t capacity,
+              const Predicate &replaces) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_.remove_if(replaces);
+    values_.push_front(value);
+    while (values_.size() > std::max<std::size_t>(1, capacity))
+      values_.pop_back();
+  }
+
+  void insert(const T &value, std::size_t capacity) {
+    insert(value, capacity, [](const T &) { return false; });
+  }
+
+ private:
+  std::mutex mutex_;
+  // most recently used values first
+  std::list<T> values_;
+};
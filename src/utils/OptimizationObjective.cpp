@@ -7,6 +7,9 @@
 
 #include <cmath>
 
+#include "base/HeuristicTable.h"
+#include "base/PlannerSettings.h"
+
 namespace og = ompl::geometric;
 
 CustomPathLengthDirectInfSampler::CustomPathLengthDirectInfSampler(
@@ -616,6 +619,76 @@ unsigned int CustomPathLengthDirectInfSampler::numberOfPhsInclusions(
   return numInclusions;
 }
 
+HeuristicInformedSampler::HeuristicInformedSampler(
+    const ob::ProblemDefinitionPtr &probDefn, unsigned int maxNumberCalls,
+    std::shared_ptr<const HeuristicTable> table)
+    : ob::InformedSampler(probDefn, maxNumberCalls),
+      ellipse_(probDefn, maxNumberCalls),
+      table_(std::move(table)) {
+  const auto *start =
+      probDefn_->getStartState(0u)->as<ob::SE2StateSpace::StateType>();
+  start_x_ = start->getX();
+  start_y_ = start->getY();
+}
+
+bool HeuristicInformedSampler::sampleUniform(ob::State *statePtr,
+                                             const ob::Cost &maxCost) {
+  for (unsigned int i = 0u; i < numIters_; ++i) {
+    if (!ellipse_.sampleUniform(statePtr, maxCost)) return false;
+    if (opt_->isCostBetterThan(heuristicSolnCost(statePtr), maxCost))
+      return true;
+  }
+  return false;
+}
+
+bool HeuristicInformedSampler::sampleUniform(ob::State *statePtr,
+                                             const ob::Cost &minCost,
+                                             const ob::Cost &maxCost) {
+  // the heuristic is at least the one of the ellipse, which already
+  // ensures the minimum cost
+  for (unsigned int i = 0u; i < numIters_; ++i) {
+    if (!ellipse_.sampleUniform(statePtr, minCost, maxCost)) return false;
+    if (opt_->isCostBetterThan(heuristicSolnCost(statePtr), maxCost))
+      return true;
+  }
+  return false;
+}
+
+double HeuristicInformedSampler::getInformedMeasure(
+    const ob::Cost &currentCost) const {
+  return ellipse_.getInformedMeasure(currentCost);
+}
+
+ob::Cost HeuristicInformedSampler::heuristicSolnCost(
+    const ob::State *statePtr) const {
+  const auto *s = statePtr->as<ob::SE2StateSpace::StateType>();
+  const ob::Cost table_cost(
+      std::hypot(s->getX() - start_x_, s->getY() - start_y_) +
+      table_->costToGo(s->getX(), s->getY()));
+  // the larger of both lower bounds
+  const ob::Cost ellipse_cost = ellipse_.heuristicSolnCost(statePtr);
+  return opt_->isCostBetterThan(table_cost, ellipse_cost) ? ellipse_cost
+                                                          : table_cost;
+}
+
+ob::InformedSamplerPtr
+CustomPathLengthOptimizationObjective::allocInformedStateSampler(
+    const ob::ProblemDefinitionPtr &probDefn,
+    unsigned int maxNumberCalls) const {
+  if (global::settings.env.heuristic.informed_sampling) {
+    OMPL_DEBUG("Using the informed state sampler of the heuristic table.");
+    return std::make_shared<HeuristicInformedSampler>(
+        probDefn, maxNumberCalls,
+        HeuristicTable::get(*global::settings.environment,
+                            global::settings.environment->goal()));
+  }
+  OMPL_DEBUG(
+      "Using a custom informed state sampler to support CC/HC steer "
+      "functions.");
+  return ob::InformedSamplerPtr(
+      new CustomPathLengthDirectInfSampler(probDefn, maxNumberCalls));
+}
+
 ob::Cost SmoothnessOptimizationObjective::stateCost(const ob::State *s) const {
   return identityCost();
 }
@@ -6,9 +6,12 @@
 #include <ompl/base/samplers/informed/PathLengthDirectInfSampler.h>
 
 #include <limits>
+#include <memory>
 
 namespace ob = ompl::base;
 
+class HeuristicTable;
+
 class CustomPathLengthDirectInfSampler : public ob::InformedSampler {
  public:
   CustomPathLengthDirectInfSampler(const ob::ProblemDefinitionPtr &probDefn,
@@ -80,6 +83,38 @@ class CustomPathLengthDirectInfSampler : public ob::InformedSampler {
   ompl::RNG rng_;
 };
 
+/** \brief Informed sampler that rejects the samples of the
+ * CustomPathLengthDirectInfSampler whose Euclidean distance from the start
+ * plus cost-to-go around the obstacles (see HeuristicTable) cannot improve
+ * the current solution.
+ *
+ * The obstacle-aware cost-to-go shrinks the informed set considerably on
+ * maze-like maps, where the ellipse covers most of the environment.
+ */
+class HeuristicInformedSampler : public ob::InformedSampler {
+ public:
+  HeuristicInformedSampler(const ob::ProblemDefinitionPtr &probDefn,
+                           unsigned int maxNumberCalls,
+                           std::shared_ptr<const HeuristicTable> table);
+
+  bool sampleUniform(ob::State *statePtr, const ob::Cost &maxCost) override;
+
+  bool sampleUniform(ob::State *statePtr, const ob::Cost &minCost,
+                     const ob::Cost &maxCost) override;
+
+  bool hasInformedMeasure() const override { return false; }
+
+  /** \brief Upper bound given by the measure of the ellipse. */
+  double getInformedMeasure(const ob::Cost &currentCost) const override;
+
+  ob::Cost heuristicSolnCost(const ob::State *statePtr) const override;
+
+ private:
+  CustomPathLengthDirectInfSampler ellipse_;
+  std::shared_ptr<const HeuristicTable> table_;
+  double start_x_{0}, start_y_{0};
+};
+
 class CustomPathLengthOptimizationObjective
     : public ob::PathLengthOptimizationObjective {
  public:
@@ -87,13 +122,7 @@ class CustomPathLengthOptimizationObjective
       : ob::PathLengthOptimizationObjective(space_info) {}
   ob::InformedSamplerPtr allocInformedStateSampler(
       const ob::ProblemDefinitionPtr &probDefn,
-      unsigned int maxNumberCalls) const override {
-    OMPL_DEBUG(
-        "Using a custom informed state sampler to support CC/HC steer "
-        "functions.");
-    return ob::InformedSamplerPtr(
-        new CustomPathLengthDirectInfSampler(probDefn, maxNumberCalls));
-  }
+      unsigned int maxNumberCalls) const override;
 };
 
 /** \brief An optimization objective for minimizing OMPL's smoothness.
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include <metrics/ClearingMetric.h>
 #include <metrics/MaxCurvatureMetric.h>
 #include <metrics/NormalizedCurvatureMetric.h>
@@ -12,6 +15,7 @@
 #include "base/PathStatistics.hpp"
 #include "base/PlannerConfigurator.hpp"
 #include "planners/AbstractPlanner.h"
+#include "planners/PlannerPool.h"
 #include "smoothers/grips/GRIPS.h"
 #include "utils/Log.h"
 
@@ -33,6 +37,123 @@ struct PathEvaluation {
     j["params"] = {};
   }
 
+  /**
+   * Constructs and configures a planner, or acquires it from the PlannerPool
+   * if planners are reused. Returns nullptr and creates an empty entry if the
+   * planner could not be created.
+   */
+  template <class PLANNER>
+  static PLANNER *createPlanner(nlohmann::json &info) {
+    const bool pooled = global::settings.benchmark.reuse_planners;
+    PLANNER *planner = nullptr;
+    try {
+      if (pooled) return PlannerPool::acquire<PLANNER>();
+      planner = new PLANNER;
+      PlannerConfigurator::configure(*planner);
+      return planner;
+    } catch (std::bad_alloc &ba) {
+      // we ran out of memory
+      OMPL_ERROR(
+          "<stats> Error </stats>\nRan out of memory while creating planner "
+          "%s: %s.",
+          AbstractPlanner::LastCreatedPlannerName.c_str(), ba.what());
+    } catch (ompl::Exception &ex) {
+      OMPL_ERROR("Unable to create new planner %s.\n%s",
+                 AbstractPlanner::LastCreatedPlannerName.c_str(), ex.what());
+    } catch (...) {
+      OMPL_ERROR(
+          "<stats> Error </stats>\nAn unknown exception occurred while "
+          "creating planner %s.",
+          AbstractPlanner::LastCreatedPlannerName.c_str());
+    }
+    createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
+    delete planner;
+    return nullptr;
+  }
+
+  /**
+   * Selects the intermediary solutions to evaluate according to
+   * global::settings.benchmark.intermediary_solutions. The first and the
+   * last (best) solution are always kept.
+   */
+  static std::vector<const AbstractPlanner::IntermediarySolution *>
+  decimateIntermediarySolutions(
+      const std::vector<AbstractPlanner::IntermediarySolution> &solutions) {
+    const auto &settings = global::settings.benchmark.intermediary_solutions;
+    std::vector<const AbstractPlanner::IntermediarySolution *> kept;
+    for (std::size_t i = 0; i < solutions.size(); ++i) {
+      const auto &is = solutions[i];
+      const bool last = i + 1 == solutions.size();
+      if (!kept.empty() && !last) {
+        const auto &previous = *kept.back();
+        if (std::abs(previous.cost - is.cost) <
+            settings.min_cost_improvement * std::abs(previous.cost))
+          continue;
+      }
+      // only the last solution of each time bucket is kept
+      if (kept.size() > 1 && settings.time_bucket > 0 &&
+          std::floor(kept.back()->time / settings.time_bucket) ==
+              std::floor(is.time / settings.time_bucket))
+        kept.back() = &is;
+      else
+        kept.push_back(&is);
+    }
+    const std::size_t max_count = settings.max_count;
+    if (max_count == 0 || kept.size() <= max_count) return kept;
+    std::vector<const AbstractPlanner::IntermediarySolution *> selected;
+    for (std::size_t i = 0; i < max_count; ++i) {
+      const std::size_t index =
+          max_count == 1
+              ? kept.size() - 1
+              : (std::size_t)std::round(i * (kept.size() - 1.) /
+                                        (max_count - 1.));
+      selected.push_back(kept[index]);
+    }
+    return selected;
+  }
+
+  /**
+   * Evaluates the decimated intermediary solutions of the planner. They are
+   * evaluated sequentially, since collision checks and steer functions share
+   * timers and lazily built data (e.g. distance fields) of the environment.
+   * Every entry has stats, which are empty if the evaluation failed.
+   */
+  static std::vector<nlohmann::json> evaluateIntermediarySolutions(
+      const AbstractPlanner &planner) {
+    const auto &settings = global::settings.benchmark.intermediary_solutions;
+    std::vector<nlohmann::json> intermediaries;
+    for (const auto *solution :
+         decimateIntermediarySolutions(planner.intermediarySolutions)) {
+      const auto &is = *solution;
+      nlohmann::json s{{"time", is.time}, {"cost", is.cost}};
+      try {
+        PathStatistics is_stats;
+        evaluate(is_stats, is.solution, &planner);
+        s["collision_time"] = is_stats.collision_time;
+        s["steering_time"] = is_stats.steering_time;
+        s["path"] = Log::serializeTrajectory(is.solution, false);
+        if (settings.store_trajectory) {
+          s["trajectory"] = Log::logTrajectory(is.solution);
+        }
+        s["stats"] = nlohmann::json(is_stats)["stats"];
+      } catch (...) {
+        OMPL_ERROR("Unable to evaluate an intermediary solution of %s.",
+                   planner.name().c_str());
+        static PathStatistics empty_stats;
+        s["stats"] = nlohmann::json(empty_stats)["stats"];
+      }
+      intermediaries.emplace_back(s);
+    }
+    return intermediaries;
+  }
+
+  /**
+   * Deletes the planner unless it is owned by the PlannerPool.
+   */
+  static void releasePlanner(AbstractPlanner *planner) {
+    if (!global::settings.benchmark.reuse_planners) delete planner;
+  }
+
  public:
   /**
    * Identifies cusps in a solution path by comparing the yaw angles between
@@ -73,12 +194,25 @@ struct PathEvaluation {
     }
   }
 
+  /**
+   * Ratio of interpolations that reused a cached steer function path since
+   * the counters have been reset, or NaN if the cache has not been used.
+   */
+  static double interpolationCacheHitRate() {
+    const auto &ompl = global::settings.ompl;
+    const std::size_t total =
+        ompl.interpolation_cache_hits + ompl.interpolation_cache_misses;
+    if (total == 0) return std::numeric_limits<double>::quiet_NaN();
+    return (double)ompl.interpolation_cache_hits / total;
+  }
+
   static bool evaluate(PathStatistics &stats,
                        const ompl::control::PathControl &path,
                        const AbstractPlanner *planner) {
     stats.planning_time = planner->planningTime();
     stats.collision_time = global::settings.environment->elapsedCollisionTime();
     stats.steering_time = global::settings.ompl.steering_timer.elapsed();
+    stats.interpolation_cache_hit_rate = interpolationCacheHitRate();
     stats.planner = planner->name();
     stats.planner_settings = planner->getSettings();
     if (path.getStateCount() < 2) {
@@ -121,8 +255,14 @@ struct PathEvaluation {
     stats.planning_time = planner->planningTime();
     stats.collision_time = global::settings.environment->elapsedCollisionTime();
     stats.steering_time = global::settings.ompl.steering_timer.elapsed();
+    stats.interpolation_cache_hit_rate = interpolationCacheHitRate();
     stats.planner = planner->name();
     stats.planner_settings = planner->getSettings();
+    const auto &roadmap = planner->roadmapStatistics;
+    stats.roadmap_reused = roadmap.reused;
+    stats.roadmap_construction_time = roadmap.construction_time;
+    stats.roadmap_load_time = roadmap.load_time;
+    stats.roadmap_query_time = roadmap.query_time;
     if (path.getStateCount() < 2) {
       stats.path_found = false;
       stats.exact_goal_path = false;
@@ -174,6 +314,8 @@ struct PathEvaluation {
     bool success;
     global::settings.environment->resetCollisionTimer();
     global::settings.ompl.steering_timer.reset();
+    global::settings.ompl.interpolation_cache_hits = 0;
+    global::settings.ompl.interpolation_cache_misses = 0;
     try {
       if (planner.run()) {
         success = PathEvaluation::evaluate(stats, planner.solution(), &planner);
@@ -210,92 +352,32 @@ struct PathEvaluation {
     // do not interpolate SBPL solutions since they do not use OMPL steer
     // functions
     if (planner.name().rfind("SBPL", 0) == 0) {
-      j["trajectory"] = Log::serializeTrajectory(planner.solution(), false);
+      j["trajectory"] = Log::logTrajectory(planner.solution(), false);
     } else {
-      j["trajectory"] = Log::serializeTrajectory(planner.solution());
+      j["trajectory"] = Log::logTrajectory(planner.solution());
     }
     j["stats"] = nlohmann::json(stats)["stats"];
 
-    // add intermediary solutions
-    std::vector<nlohmann::json> intermediaries;
-    for (const auto &is : planner.intermediarySolutions) {
-      PathStatistics is_stats;
-      evaluate(is_stats, is.solution, &planner);
-      nlohmann::json s{{"time", is.time},
-                       {"collision_time", is_stats.collision_time},
-                       {"steering_time", is_stats.steering_time},
-                       {"cost", is.cost},
-                       {"trajectory", Log::serializeTrajectory(is.solution)},
-                       {"path", Log::serializeTrajectory(is.solution, false)},
-                       {"stats", nlohmann::json(is_stats)["stats"]}};
-      intermediaries.emplace_back(s);
-    }
-    j["intermediary_solutions"] = intermediaries;
+    j["intermediary_solutions"] = evaluateIntermediarySolutions(planner);
     return success;
   }
 
   template <class PLANNER>
   static bool evaluate(nlohmann::json &info) {
-    PLANNER *planner = nullptr;
-    try {
-      planner = new PLANNER;
-      PlannerConfigurator::configure(*planner);
-    } catch (std::bad_alloc &ba) {
-      // we ran out of memory
-      OMPL_ERROR(
-          "<stats> Error </stats>\nRan out of memory while creating planner "
-          "%s: %s.",
-          AbstractPlanner::LastCreatedPlannerName.c_str(), ba.what());
-      createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
-      delete planner;
-      return false;
-    } catch (ompl::Exception &ex) {
-      OMPL_ERROR("Unable to create new planner %s.\n%s",
-                 AbstractPlanner::LastCreatedPlannerName.c_str(), ex.what());
-      createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
-      delete planner;
-      return false;
-    } catch (...) {
-      OMPL_ERROR(
-          "<stats> Error </stats>\nAn unknown exception occurred while "
-          "creating planner %s.",
-          AbstractPlanner::LastCreatedPlannerName.c_str());
-      createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
-      delete planner;
-      return false;
-    }
+    PLANNER *planner = createPlanner<PLANNER>(info);
+    if (planner == nullptr) return false;
     auto result = evaluate(*planner, info);
-    delete planner;
+    releasePlanner(planner);
     return result;
   }
 
   template <class PLANNER>
   static bool evaluateSmoothers(nlohmann::json &info) {
-    PLANNER *planner = nullptr;
-    try {
-      planner = new PLANNER;
-      PlannerConfigurator::configure(*planner);
-    } catch (std::bad_alloc &ba) {
-      // we ran out of memory
-      OMPL_ERROR(
-          "<stats> Error </stats>\nRan out of memory while creating planner "
-          "%s: %s.",
-          AbstractPlanner::LastCreatedPlannerName.c_str(), ba.what());
-      createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
-      delete planner;
-      return false;
-    } catch (...) {
-      OMPL_ERROR(
-          "<stats> Error </stats>\nAn unknown exception occurred while "
-          "creating planner %s.",
-          AbstractPlanner::LastCreatedPlannerName.c_str());
-      createEmptyEntry(AbstractPlanner::LastCreatedPlannerName, info);
-      delete planner;
-      return false;
-    }
+    PLANNER *planner = createPlanner<PLANNER>(info);
+    if (planner == nullptr) return false;
     if (!evaluate<PLANNER>(*planner, info)) {
       OMPL_WARN("Cannot evaluate smoothers since no solution could be found.");
-      delete planner;
+      releasePlanner(planner);
       return false;
     }
     auto &j = info["plans"][planner->name()]["smoothing"];
@@ -325,7 +407,7 @@ struct PathEvaluation {
           {"inserted_nodes", GRIPS::insertedNodes},
           {"pruning_rounds", GRIPS::pruningRounds},
           {"cost", grips.length()},
-          {"trajectory", Log::serializeTrajectory(grips)},
+          {"trajectory", Log::logTrajectory(grips)},
           {"path", Log::serializeTrajectory(grips, false)},
           {"stats", nlohmann::json(grips_stats)["stats"]},
           {"round_stats", GRIPS::statsPerRound}};
@@ -368,7 +450,7 @@ struct PathEvaluation {
           {"name", "Shortcut"},
           {"cost", tr.trajectory.length()},
           {"path", Log::serializeTrajectory(tr.trajectory, false)},
-          {"trajectory", Log::serializeTrajectory(tr.trajectory)},
+          {"trajectory", Log::logTrajectory(tr.trajectory)},
           {"stats", nlohmann::json(stats)["stats"]}};
     }
     if (global::settings.benchmark.smoothing.ompl_bspline) {
@@ -386,7 +468,7 @@ struct PathEvaluation {
           {"name", "B-Spline"},
           {"cost", tr.trajectory.length()},
           {"path", Log::serializeTrajectory(tr.trajectory, false)},
-          {"trajectory", Log::serializeTrajectory(tr.trajectory)},
+          {"trajectory", Log::logTrajectory(tr.trajectory)},
           {"stats", nlohmann::json(stats)["stats"]}};
     }
     if (global::settings.benchmark.smoothing.ompl_simplify_max) {
@@ -404,25 +486,93 @@ struct PathEvaluation {
           {"name", "SimplifyMax"},
           {"cost", tr.trajectory.length()},
           {"path", Log::serializeTrajectory(tr.trajectory, false)},
-          {"trajectory", Log::serializeTrajectory(tr.trajectory)},
+          {"trajectory", Log::logTrajectory(tr.trajectory)},
           {"stats", nlohmann::json(stats)["stats"]}};
     }
 
-    delete planner;
+    releasePlanner(planner);
     return true;
   }
 
   /**
-   * Evaluates an anytime path planner by running the planner for each of the
-   * provided time intervals (in seconds). This method populates the
-   * "intermediary_solutions" field of the JSON object for the given planner.
+   * Evaluates an anytime path planner at each of the provided time intervals
+   * (in seconds). Planners that support checkpoints run once for the longest
+   * interval and record their best solution at every interval, which is
+   * evaluated after the run. Other planners are rerun for each interval.
+   * This method populates the "intermediary_solutions" field of the JSON
+   * object for the given planner.
    */
   // TODO remove? Python front-end adds this functionality
   template <class PLANNER>
   static bool evaluateAnytime(nlohmann::json &info) {
     PLANNER planner;
-    const std::vector<double> times =
-        global::settings.benchmark.anytime_intervals;
+    std::vector<double> times = global::settings.benchmark.anytime_intervals;
+    std::sort(times.begin(), times.end());
+    if (times.empty()) return false;
+    if (!planner.supportsCheckpoints())
+      return evaluateAnytimeReruns(planner, times, info);
+
+    PathStatistics stats(planner.name());
+    auto &j = info["plans"][planner.name()];
+    const double cached_time_limit = global::settings.max_planning_time;
+    global::settings.max_planning_time = times.back();
+    planner.checkpoints = times;
+    OMPL_INFORM(("Running " + planner.name() + " for " +
+                 std::to_string(times.back()) + "s...")
+                    .c_str());
+    global::settings.environment->resetCollisionTimer();
+    global::settings.ompl.steering_timer.reset();
+    bool success = false;
+    if (planner.run()) {
+      success = PathEvaluation::evaluate(stats, planner.solution(), &planner);
+      j["path"] = Log::serializeTrajectory(planner.solution(), false);
+    } else {
+      j["path"] = {};
+    }
+    std::cout << stats << std::endl;
+    std::cout << "Steer function: "
+              << Steering::to_string(global::settings.steer.steering_type)
+              << std::endl;
+
+    std::vector<nlohmann::json> intermediaries;
+    for (std::size_t i = 0; i < planner.checkpointSolutions.size(); ++i) {
+      const auto &checkpoint = planner.checkpointSolutions[i];
+      PathStatistics is_stats(planner.name());
+      evaluate(is_stats, checkpoint.solution, &planner);
+      // evaluate() reads the timers after the run, which include the whole
+      // run and the collision checks of the evaluation
+      is_stats.planning_time = checkpoint.time;
+      is_stats.collision_time = checkpoint.collision_time;
+      is_stats.steering_time = checkpoint.steering_time;
+      nlohmann::json s{
+          {"time", checkpoint.time},
+          {"collision_time", checkpoint.collision_time},
+          {"max_time", times[i]},
+          {"cost", is_stats.path_length},
+          {"trajectory", Log::logTrajectory(checkpoint.solution)},
+          {"path", Log::serializeTrajectory(checkpoint.solution, false)},
+          {"stats", nlohmann::json(is_stats)["stats"]}};
+      intermediaries.emplace_back(s);
+    }
+    planner.checkpoints.clear();
+
+    j["intermediary_solutions"] = intermediaries;
+    j["trajectory"] = Log::logTrajectory(planner.solution());
+    j["stats"] = nlohmann::json(stats)["stats"];
+    // restore global time limit
+    global::settings.max_planning_time = cached_time_limit;
+    return success;
+  }
+
+ private:
+  /**
+   * Anytime evaluation for planners without checkpoint support, which are run
+   * from scratch for each time interval.
+   */
+  template <class PLANNER>
+  static bool evaluateAnytimeReruns(PLANNER &planner,
+                                    const std::vector<double> &times,
+                                    nlohmann::json &info) {
     PathStatistics stats(planner.name());
     auto &j = info["plans"][planner.name()];
     std::vector<nlohmann::json> intermediaries;
@@ -452,7 +602,7 @@ struct PathEvaluation {
            global::settings.environment->elapsedCollisionTime()},
           {"max_time", time},
           {"cost", stats.path_length},
-          {"trajectory", Log::serializeTrajectory(planner.solution())},
+          {"trajectory", Log::logTrajectory(planner.solution())},
           {"path", Log::serializeTrajectory(planner.solution(), false)},
           {"stats", nlohmann::json(stats)["stats"]}};
       intermediaries.emplace_back(s);
@@ -460,9 +610,9 @@ struct PathEvaluation {
 
     j["intermediary_solutions"] = intermediaries;
     if (planner.name().rfind("SBPL", 0) == 0) {
-      j["trajectory"] = Log::serializeTrajectory(planner.solution(), false);
+      j["trajectory"] = Log::logTrajectory(planner.solution(), false);
     } else {
-      j["trajectory"] = Log::serializeTrajectory(planner.solution());
+      j["trajectory"] = Log::logTrajectory(planner.solution());
     }
     j["stats"] = nlohmann::json(stats)["stats"];
     // restore global time limit
@@ -470,5 +620,6 @@ struct PathEvaluation {
     return success;
   }
 
+ public:
   PathEvaluation() = delete;
 };
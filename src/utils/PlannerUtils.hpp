@@ -4,8 +4,12 @@
 #include <ompl/control/PathControl.h>
 #include <cmath>
 #include <iomanip>
+#include <memory>
 #include "base/PlannerSettings.h"
+#include "base/BisectionMotionValidator.h"
+#include "base/ClearanceMotionValidator.h"
 #include "base/Primitives.h"
+#include "base/environments/GridMaze.h"
 
 #if QT_SUPPORT
 #include "gui/QtVisualizer.h"
@@ -135,6 +139,49 @@ class PlannerUtils {
     return false;
   }
 
+  /**
+   * Returns the grid environment if straight segments can be checked exactly
+   * by traversing the grid (see GridMaze::thickLineOfSight), i.e. if linear
+   * steering and the point collision model are used on a grid environment
+   * and PlannerSettings::GlobalSettings::EnvironmentSettings::CollisionSettings::exact_line_of_sight
+   * is enabled.
+   *
+   * @returns The grid environment, or nullptr if the segments have to be
+   * interpolated.
+   */
+  static GridMaze *lineOfSightGrid() {
+    if (!global::settings.env.collision.exact_line_of_sight ||
+        global::settings.steer.steering_type != Steering::STEER_TYPE_LINEAR ||
+        global::settings.env.collision.collision_model != robot::ROBOT_POINT)
+      return nullptr;
+    return dynamic_cast<GridMaze *>(global::settings.environment.get());
+  }
+
+  /**
+   * Motion validator of the given type for the current space information and
+   * environment. It is constructed once per thread and reused until either of
+   * them changes.
+   */
+  template <typename MotionValidatorT>
+  static const MotionValidatorT &motionValidator() {
+    struct Cache {
+      ob::SpaceInformationPtr si;
+      std::shared_ptr<Environment> environment;
+      // declared last so that it is destroyed before the space information
+      std::unique_ptr<MotionValidatorT> validator;
+    };
+    thread_local Cache cache;
+    if (!cache.validator || cache.si != global::settings.ompl.space_info ||
+        cache.environment != global::settings.environment) {
+      cache.validator.reset();
+      cache.si = global::settings.ompl.space_info;
+      cache.environment = global::settings.environment;
+      cache.validator =
+          std::make_unique<MotionValidatorT>(cache.si, cache.environment);
+    }
+    return *cache.validator;
+  }
+
   /**
    * Collision check of segment between two states.
    *
@@ -143,6 +190,14 @@ class PlannerUtils {
    * The environment is set through PlannerSettings::GlobalSettings::environment.
    * The steering function used to compute the path between the two state is defined by
    * PlannerSettings::GlobalSettings::OmplSettings::state_space.
+   * With PlannerSettings::GlobalSettings::EnvironmentSettings::CollisionSettings::adaptive_motion_validation
+   * the segment is checked by the ClearanceMotionValidator instead of
+   * interpolating it at a fixed number of states.
+   * With PlannerSettings::GlobalSettings::EnvironmentSettings::CollisionSettings::bisection_motion_validation
+   * the segment is checked by the BisectionMotionValidator, which stops at
+   * the first collision instead of interpolating the whole segment first.
+   * On grids, segments through open space are accepted by
+   * GridMaze::motionFree() before any of these checks.
    *
    * @param a The first state of the path segment to check.
    * @param b The last state of the path segment to check.
@@ -157,6 +212,29 @@ class PlannerUtils {
               << global::settings.ompl.state_space->validSegmentCount(a, b)
               << std::endl;
 #endif
+    if (auto *grid = lineOfSightGrid()) {
+      return !grid->thickLineOfSight(
+          a->as<State>()->getX(), a->as<State>()->getY(),
+          b->as<State>()->getX(), b->as<State>()->getY());
+    }
+    // motions through open space are accepted without sampling them
+    if (auto *grid =
+            dynamic_cast<GridMaze *>(global::settings.environment.get())) {
+      if (BisectionMotionValidator::supportsSteering() &&
+          grid->motionFree(a, b,
+                           global::settings.ompl.state_space->distance(a, b)))
+        return false;
+    }
+    if (global::settings.env.collision.adaptive_motion_validation &&
+        ClearanceMotionValidator::supportsSteering()) {
+      return !(global::settings.environment->checkValidity(a) &&
+               motionValidator<ClearanceMotionValidator>().checkMotion(a, b));
+    }
+    if (global::settings.env.collision.bisection_motion_validation &&
+        BisectionMotionValidator::supportsSteering()) {
+      return !(global::settings.environment->checkValidity(a) &&
+               motionValidator<BisectionMotionValidator>().checkMotion(a, b));
+    }
     ompl::geometric::PathGeometric p(global::settings.ompl.space_info, a, b);
     p = interpolated(p);
     return collides(p);
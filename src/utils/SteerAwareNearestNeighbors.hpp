@@ -0,0 +1,469 @@
+#pragma once
+
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <ompl/base/spaces/SE2StateSpace.h>
+#include <ompl/base/spaces/SO2StateSpace.h>
+#include <ompl/datastructures/NearestNeighbors.h>
+#include <ompl/geometric/planners/prm/ConnectionStrategy.h>
+#include <ompl/geometric/planners/prm/PRM.h>
+#include <ompl/tools/config/MagicConstants.h>
+#include <ompl/util/Exception.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/PlannerSettings.h"
+#include "steer_functions/BatchDistance.h"
+
+namespace ob = ompl::base;
+namespace og = ompl::geometric;
+
+namespace steer_aware_nn {
+template <typename T, typename = void>
+struct HasGetState : std::false_type {};
+template <typename T>
+struct HasGetState<T, std::void_t<decltype(std::declval<T>()->getState())>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct HasStateFunction : std::false_type {};
+template <typename T>
+struct HasStateFunction<T, std::void_t<decltype(std::declval<T>()->state())>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct HasStateMember : std::false_type {};
+template <typename T>
+struct HasStateMember<T, std::void_t<decltype(std::declval<T>()->state)>>
+    : std::true_type {};
+}  // namespace steer_aware_nn
+
+/**
+ * Nearest-neighbor structure for SE(2) planning with expensive steer
+ * functions. Elements are indexed by their position in a 2D k-d tree. The
+ * steer distance is only computed for candidates whose lower bound (the
+ * Euclidean distance, and for curvature-bounded steer functions the turning
+ * radius times the heading difference) can improve the result.
+ *
+ * The state of an element is obtained from the motion or vertex type of the
+ * planner (RRT*, FMT*, BIT*), or from the state accessor if the elements do
+ * not provide it (e.g. the boost graph vertices of PRM, see usePRM()).
+ *
+ * The lower bounds only hold if the distance function of the planner is the
+ * distance of the state space, i.e. for the path length objective. The
+ * candidates that pass the lower bound are collected and their distances are
+ * computed in batches via BatchDistance, which may look them up in the steer
+ * distance table.
+ */
+template <typename _T>
+class SteerAwareNearestNeighbors : public ompl::NearestNeighbors<_T> {
+ public:
+  typedef std::function<const ob::State *(const _T &)> StateAccessor;
+
+  SteerAwareNearestNeighbors() {
+    const auto &space = global::settings.ompl.state_space;
+    batch_ = dynamic_cast<const BatchDistance *>(space.get());
+    se2_ = dynamic_cast<const ob::SE2StateSpace *>(space.get()) != nullptr;
+    switch (global::settings.steer.steering_type) {
+      case Steering::STEER_TYPE_REEDS_SHEPP:
+      case Steering::STEER_TYPE_DUBINS:
+        heading_weight_ = global::settings.steer.car_turning_radius;
+        break;
+      case Steering::STEER_TYPE_CC_DUBINS:
+      case Steering::STEER_TYPE_CC_REEDS_SHEPP:
+      case Steering::STEER_TYPE_HC_REEDS_SHEPP:
+        heading_weight_ = 1. / global::settings.steer.hc_cc.kappa;
+        break;
+      case Steering::STEER_TYPE_LINEAR: {
+        // weights of the R^2 and SO(2) subspaces of the SE(2) distance
+        const auto *compound = space->as<ob::CompoundStateSpace>();
+        position_weight_ = compound->getSubspaceWeight(0);
+        heading_weight_ = compound->getSubspaceWeight(1);
+        additive_heading_ = true;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  ~SteerAwareNearestNeighbors() override = default;
+
+  /**
+   * Maps elements to their states if they do not provide them themselves.
+   */
+  void setStateAccessor(const StateAccessor &accessor) {
+    stateAccessor_ = accessor;
+  }
+
+  bool reportsSortedResults() const override { return true; }
+
+  void clear() override {
+    nodes_.clear();
+    root_ = -1;
+    removed_ = 0;
+    balanced_size_ = 0;
+  }
+
+  void add(const _T &data) override {
+    nodes_.emplace_back(makeNode(data));
+    insert((int)nodes_.size() - 1);
+    if (nodes_.size() >= 2 * std::max<std::size_t>(balanced_size_, 32))
+      rebuild();
+  }
+
+  void add(const std::vector<_T> &data) override {
+    for (const auto &d : data) nodes_.emplace_back(makeNode(d));
+    rebuild();
+  }
+
+  bool remove(const _T &data) override {
+    if (root_ < 0) return false;
+    const Node query = makeNode(data);
+    std::vector<int> stack{root_};
+    while (!stack.empty()) {
+      const int i = stack.back();
+      stack.pop_back();
+      Node &node = nodes_[i];
+      if (!node.removed && node.data == data) {
+        node.removed = true;
+        ++removed_;
+        if (2 * removed_ > nodes_.size()) rebuild();
+        return true;
+      }
+      const double diff = key(query, node.axis) - key(node, node.axis);
+      // equal keys may end up on both sides after rebalancing
+      if (diff <= 0 && node.left >= 0) stack.push_back(node.left);
+      if (diff >= 0 && node.right >= 0) stack.push_back(node.right);
+    }
+    return false;
+  }
+
+  _T nearest(const _T &data) const override {
+    const Node query = makeNode(data);
+    double best = std::numeric_limits<double>::infinity();
+    int best_index = -1;
+    searchDistances(
+        data, query, [&]() { return best; },
+        [&](double d, int i) {
+          if (d < best) {
+            best = d;
+            best_index = i;
+          }
+        });
+    if (best_index < 0)
+      throw ompl::Exception(
+          "No elements found in nearest neighbors data structure");
+    return nodes_[best_index].data;
+  }
+
+  void nearestK(const _T &data, std::size_t k,
+                std::vector<_T> &nbh) const override {
+    nbh.clear();
+    if (k == 0) return;
+    const Node query = makeNode(data);
+    // max-heap of the k closest elements found so far
+    std::vector<std::pair<double, int>> heap;
+    heap.reserve(k + 1);
+    const auto bound = [&]() {
+      return heap.size() < k ? std::numeric_limits<double>::infinity()
+                             : heap.front().first;
+    };
+    searchDistances(data, query, bound, [&](double d, int i) {
+      if (d >= bound()) return;
+      heap.emplace_back(d, i);
+      std::push_heap(heap.begin(), heap.end());
+      if (heap.size() > k) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.pop_back();
+      }
+    });
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto &entry : heap) nbh.push_back(nodes_[entry.second].data);
+  }
+
+  void nearestR(const _T &data, double radius,
+                std::vector<_T> &nbh) const override {
+    nbh.clear();
+    const Node query = makeNode(data);
+    std::vector<std::pair<double, int>> result;
+    searchDistances(
+        data, query, [radius]() { return radius; },
+        [&](double d, int i) {
+          if (d <= radius) result.emplace_back(d, i);
+        });
+    std::sort(result.begin(), result.end());
+    for (const auto &entry : result) nbh.push_back(nodes_[entry.second].data);
+  }
+
+  std::size_t size() const override { return nodes_.size() - removed_; }
+
+  void list(std::vector<_T> &data) const override {
+    data.clear();
+    for (const auto &node : nodes_)
+      if (!node.removed) data.push_back(node.data);
+  }
+
+ private:
+  struct Node {
+    _T data;
+    const ob::State *state{nullptr};
+    double x{0}, y{0}, yaw{0};
+    int left{-1}, right{-1};
+    unsigned char axis{0};
+    bool removed{false};
+  };
+
+  const ob::State *stateOf(const _T &data) const {
+    if (stateAccessor_) return stateAccessor_(data);
+    if constexpr (steer_aware_nn::HasGetState<_T>::value)
+      return data->getState();
+    else if constexpr (steer_aware_nn::HasStateFunction<_T>::value)
+      return data->state();
+    else if constexpr (steer_aware_nn::HasStateMember<_T>::value)
+      return data->state;
+    else
+      throw ompl::Exception(
+          "SteerAwareNearestNeighbors requires a state accessor for this "
+          "element type");
+  }
+
+  Node makeNode(const _T &data) const {
+    Node node{data, stateOf(data)};
+    const ob::State *state = node.state;
+    if (se2_) {
+      const auto *s = state->as<ob::SE2StateSpace::StateType>();
+      node.x = s->getX();
+      node.y = s->getY();
+      node.yaw = s->getYaw();
+    } else {
+      const auto *s = state->as<ob::CompoundState>();
+      const auto *position = s->as<ob::RealVectorStateSpace::StateType>(0);
+      node.x = position->values[0];
+      node.y = position->values[1];
+      node.yaw = s->as<ob::SO2StateSpace::StateType>(1)->value;
+    }
+    return node;
+  }
+
+  static double key(const Node &node, unsigned char axis) {
+    return axis == 0 ? node.x : node.y;
+  }
+
+  /**
+   * Lower bound of the steer distance between the states of both nodes.
+   */
+  double lowerBound(const Node &a, const Node &b) const {
+    const double euclidean =
+        position_weight_ * std::hypot(a.x - b.x, a.y - b.y);
+    if (heading_weight_ <= 0) return euclidean;
+    double heading = std::fmod(std::abs(a.yaw - b.yaw), 2. * M_PI);
+    if (heading > M_PI) heading = 2. * M_PI - heading;
+    if (additive_heading_) return euclidean + heading_weight_ * heading;
+    return std::max(euclidean, heading_weight_ * heading);
+  }
+
+  void insert(int index) {
+    if (root_ < 0) {
+      root_ = index;
+      nodes_[index].axis = 0;
+      return;
+    }
+    int i = root_;
+    while (true) {
+      Node &node = nodes_[i];
+      int &child = key(nodes_[index], node.axis) < key(node, node.axis)
+                       ? node.left
+                       : node.right;
+      if (child < 0) {
+        child = index;
+        nodes_[index].axis = (unsigned char)(1 - node.axis);
+        return;
+      }
+      i = child;
+    }
+  }
+
+  /**
+   * Drops removed elements and rebuilds a balanced tree.
+   */
+  void rebuild() {
+    std::vector<Node> live;
+    live.reserve(nodes_.size() - removed_);
+    for (auto &node : nodes_) {
+      if (node.removed) continue;
+      node.left = node.right = -1;
+      live.emplace_back(std::move(node));
+    }
+    nodes_ = std::move(live);
+    removed_ = 0;
+    balanced_size_ = nodes_.size();
+    std::vector<int> order(nodes_.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = (int)i;
+    root_ = build(order.begin(), order.end(), 0);
+  }
+
+  int build(std::vector<int>::iterator begin, std::vector<int>::iterator end,
+            unsigned char axis) {
+    if (begin == end) return -1;
+    const auto mid = begin + (end - begin) / 2;
+    std::nth_element(begin, mid, end, [&](int a, int b) {
+      return key(nodes_[a], axis) < key(nodes_[b], axis);
+    });
+    Node &node = nodes_[*mid];
+    node.axis = axis;
+    const auto next = (unsigned char)(1 - axis);
+    node.left = build(begin, mid, next);
+    node.right = build(mid + 1, end, next);
+    return *mid;
+  }
+
+  /**
+   * Visits the elements of all subtrees whose Euclidean distance to the query
+   * does not exceed the current bound, nearer subtrees first.
+   */
+  template <typename Bound, typename Visit>
+  void search(const Node &query, const Bound &bound,
+              const Visit &visit) const {
+    if (root_ < 0) return;
+    std::vector<std::pair<int, double>> stack{{root_, 0.}};
+    while (!stack.empty()) {
+      const auto [i, plane_distance] = stack.back();
+      stack.pop_back();
+      if (position_weight_ * plane_distance > bound()) continue;
+      const Node &node = nodes_[i];
+      if (!node.removed) visit(i);
+      const double diff = key(query, node.axis) - key(node, node.axis);
+      const int near = diff < 0 ? node.left : node.right;
+      const int far = diff < 0 ? node.right : node.left;
+      if (far >= 0)
+        stack.emplace_back(far, std::max(plane_distance, std::abs(diff)));
+      if (near >= 0) stack.emplace_back(near, plane_distance);
+    }
+  }
+
+  /**
+   * Runs search() and computes the distances of all elements whose lower
+   * bound does not exceed the current bound, which are then passed to
+   * accept(distance, index).
+   */
+  template <typename Bound, typename Accept>
+  void searchDistances(const _T &data, const Node &query, const Bound &bound,
+                       const Accept &accept) const {
+    if (batch_ == nullptr) {
+      search(query, bound, [&](int i) {
+        if (lowerBound(query, nodes_[i]) > bound()) return;
+        accept(this->distFun_(data, nodes_[i].data), i);
+      });
+      return;
+    }
+    // candidates whose distances have not been computed yet, the bound is
+    // updated once per batch
+    std::array<int, BatchSize> candidates;
+    std::array<const ob::State *, BatchSize> states;
+    std::array<double, BatchSize> distances;
+    std::size_t count = 0;
+    const auto flush = [&]() {
+      batch_->distanceMany(query.state, states.data(), distances.data(),
+                           count);
+      for (std::size_t j = 0; j < count; ++j)
+        accept(distances[j], candidates[j]);
+      count = 0;
+    };
+    search(query, bound, [&](int i) {
+      if (lowerBound(query, nodes_[i]) > bound()) return;
+      candidates[count] = i;
+      states[count] = nodes_[i].state;
+      if (++count == BatchSize) flush();
+    });
+    if (count > 0) flush();
+  }
+
+  static constexpr std::size_t BatchSize = 16;
+
+  std::vector<Node> nodes_;
+  int root_{-1};
+  std::size_t removed_{0};
+  std::size_t balanced_size_{0};
+  bool se2_{true};
+  double position_weight_{1};
+  double heading_weight_{0};
+  bool additive_heading_{false};
+  const BatchDistance *batch_{nullptr};
+  StateAccessor stateAccessor_;
+};
+
+namespace steer_aware_nn {
+/**
+ * Exposes the nearest neighbors and the connection strategy of PRM, which the
+ * planner only replaces as a whole, clearing its roadmap.
+ */
+struct PRMAccess : public og::PRM {
+  using og::PRM::connectionStrategy_;
+  using og::PRM::nn_;
+  using og::PRM::starStrategy_;
+  using og::PRM::userSetConnectionStrategy_;
+};
+
+/**
+ * Number of neighbors PRM connects new milestones to, as configured through
+ * the max_nearest_neighbors parameter.
+ */
+inline unsigned int maxNearestNeighbors(const og::PRM &prm) {
+  std::string value;
+  if (prm.params().getParam("max_nearest_neighbors", value) &&
+      !value.empty())
+    return (unsigned int)std::stoul(value);
+  return ompl::magic::DEFAULT_NEAREST_NEIGHBORS;
+}
+
+/**
+ * Replaces the nearest neighbors of the PRM (or PRM*) by a steer-aware
+ * structure that obtains the vertex states from this planner. Vertices that
+ * are already in the roadmap (e.g. loaded from planner data) are kept.
+ *
+ * The k-nearest (or k*-nearest) connection strategy is bound to the new
+ * structure as well, so that the neighbors of every milestone are ranked by
+ * batched distances. PRM would otherwise keep querying the replaced structure
+ * if it had already created its connection strategy (e.g. when
+ * max_nearest_neighbors was set). Connection strategies set by the user are
+ * kept.
+ */
+inline void usePRM(og::PRM &prm) {
+  auto &nn = prm.*(&PRMAccess::nn_);
+  auto steer_aware =
+      std::make_shared<SteerAwareNearestNeighbors<og::PRM::Vertex>>();
+  const og::PRM *planner = &prm;
+  steer_aware->setStateAccessor(
+      [planner](const og::PRM::Vertex &vertex) -> const ob::State * {
+        return boost::get(og::PRM::vertex_state_t(), planner->getRoadmap(),
+                          vertex);
+      });
+  if (nn) {
+    steer_aware->setDistanceFunction(nn->getDistanceFunction());
+    std::vector<og::PRM::Vertex> vertices;
+    nn->list(vertices);
+    steer_aware->add(vertices);
+  }
+  nn = steer_aware;
+
+  if (prm.*(&PRMAccess::userSetConnectionStrategy_)) return;
+  auto &strategy = prm.*(&PRMAccess::connectionStrategy_);
+  if (prm.*(&PRMAccess::starStrategy_)) {
+    strategy = og::KStarStrategy<og::PRM::Vertex>(
+        [planner]() { return planner->milestoneCount(); }, steer_aware,
+        planner->getSpaceInformation()->getStateDimension());
+  } else {
+    strategy = og::KStrategy<og::PRM::Vertex>(maxNearestNeighbors(prm),
+                                              steer_aware);
+  }
+}
+}  // namespace steer_aware_nn
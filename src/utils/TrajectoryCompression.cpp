@@ -0,0 +1,150 @@
+#include "TrajectoryCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/PlannerSettings.h"
+
+namespace {
+struct Deviation {
+  double position{0};
+  double yaw{0};
+};
+
+/**
+ * Deviation of state p from the linear interpolation between a and b. The
+ * interpolation parameter is given by the projection of p onto the segment
+ * in the plane, or by the index of p if a and b coincide in the plane (e.g.
+ * turning on the spot).
+ */
+Deviation deviation(const std::array<double, 3> &p,
+                    const std::array<double, 3> &a,
+                    const std::array<double, 3> &b, double index_ratio) {
+  const double dx = b[0] - a[0], dy = b[1] - a[1];
+  const double length2 = dx * dx + dy * dy;
+  double t = index_ratio;
+  if (length2 > 1e-12) {
+    t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / length2;
+    t = std::min(1., std::max(0., t));
+  }
+  Deviation d;
+  d.position = std::hypot(p[0] - (a[0] + t * dx), p[1] - (a[1] + t * dy));
+  d.yaw = std::abs(p[2] - (a[2] + t * (b[2] - a[2])));
+  return d;
+}
+
+double relative(double error, double tolerance) {
+  if (tolerance > 0) return error / tolerance;
+  return error > 0 ? HUGE_VAL : 0.;
+}
+}  // namespace
+
+nlohmann::json TrajectoryCompression::encode(
+    const std::vector<std::array<double, 3>> &trajectory) {
+  const auto &settings = global::settings.benchmark.trajectory_compression;
+  if (!settings.enabled) return trajectory;
+  return compress(trajectory, settings.position_tolerance,
+                  settings.yaw_tolerance, settings.resolution,
+                  settings.yaw_resolution);
+}
+
+nlohmann::json TrajectoryCompression::compress(
+    const std::vector<std::array<double, 3>> &trajectory,
+    double position_tolerance, double yaw_tolerance, double resolution,
+    double yaw_resolution) {
+  const std::size_t n = trajectory.size();
+  // unwrap the yaw angles so that they can be interpolated linearly
+  std::vector<std::array<double, 3>> states(trajectory);
+  for (std::size_t i = 1; i < n; ++i) {
+    const double delta = trajectory[i][2] - trajectory[i - 1][2];
+    states[i][2] = states[i - 1][2] + std::remainder(delta, 2. * M_PI);
+  }
+
+  // Douglas-Peucker simplification (iterative to bound the stack depth)
+  std::vector<bool> retained(n, n <= 2);
+  if (n > 2) {
+    retained.front() = retained.back() = true;
+    std::vector<std::pair<std::size_t, std::size_t>> segments{{0, n - 1}};
+    while (!segments.empty()) {
+      const auto [a, b] = segments.back();
+      segments.pop_back();
+      double worst = 0;
+      std::size_t split = a;
+      for (std::size_t i = a + 1; i < b; ++i) {
+        const auto d = deviation(states[i], states[a], states[b],
+                                 double(i - a) / double(b - a));
+        // the tolerance is exceeded if this ratio is greater than one
+        const double ratio = std::max(relative(d.position, position_tolerance),
+                                      relative(d.yaw, yaw_tolerance));
+        if (ratio > worst) {
+          worst = ratio;
+          split = i;
+        }
+      }
+      if (worst > 1.) {
+        retained[split] = true;
+        segments.emplace_back(a, split);
+        segments.emplace_back(split, b);
+      }
+    }
+  }
+
+  // quantise and delta-encode the retained states
+  std::vector<long long> data;
+  std::vector<std::size_t> indices;
+  std::array<long long, 3> previous{0, 0, 0};
+  for (std::size_t i = 0; i < n; ++i) {
+    if (!retained[i]) continue;
+    const std::array<long long, 3> q{
+        std::llround(states[i][0] / resolution),
+        std::llround(states[i][1] / resolution),
+        std::llround(states[i][2] / yaw_resolution)};
+    for (int k = 0; k < 3; ++k) data.push_back(q[k] - previous[k]);
+    previous = q;
+    indices.push_back(i);
+  }
+
+  nlohmann::json encoded{{"encoding", "dp_delta"},
+                         {"count", n},
+                         {"resolution", resolution},
+                         {"yaw_resolution", yaw_resolution},
+                         {"position_error", 0.},
+                         {"yaw_error", 0.},
+                         {"data", data}};
+
+  // the achieved error bound includes the quantisation error
+  const auto decoded = decompress(encoded);
+  Deviation worst;
+  for (std::size_t k = 0; k < indices.size(); ++k) {
+    const std::size_t a = indices[k];
+    const bool last = k + 1 == indices.size();
+    const std::size_t b = last ? a : indices[k + 1];
+    for (std::size_t i = a; i < b || i == a; ++i) {
+      const auto d =
+          deviation(states[i], decoded[k], decoded[last ? k : k + 1],
+                    last ? 0. : double(i - a) / double(b - a));
+      worst.position = std::max(worst.position, d.position);
+      worst.yaw = std::max(worst.yaw, d.yaw);
+    }
+  }
+  encoded["position_error"] = worst.position;
+  encoded["yaw_error"] = worst.yaw;
+  return encoded;
+}
+
+std::vector<std::array<double, 3>> TrajectoryCompression::decompress(
+    const nlohmann::json &encoded) {
+  const double resolution = encoded["resolution"];
+  const double yaw_resolution = encoded["yaw_resolution"];
+  const auto data = encoded["data"].get<std::vector<long long>>();
+  std::vector<std::array<double, 3>> states;
+  std::array<long long, 3> q{0, 0, 0};
+  for (std::size_t i = 0; i + 2 < data.size(); i += 3) {
+    for (int k = 0; k < 3; ++k) q[k] += data[i + k];
+    // the yaw angles are kept unwrapped here
+    states.push_back(
+        {q[0] * resolution, q[1] * resolution, q[2] * yaw_resolution});
+  }
+  return states;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <nlohmann/json.hpp>
+#include <vector>
+
+/**
+ * Error-bounded lossy encoding of the (x, y, yaw) trajectories written to the
+ * log. A trajectory is simplified by Douglas-Peucker such that no original
+ * state deviates from the linear interpolation between the retained states
+ * by more than the position and yaw tolerances. The retained states are
+ * quantised to integer multiples of the resolutions, and all but the first
+ * are stored as differences to their predecessor.
+ *
+ * An encoded trajectory is a JSON object
+ *   {"encoding": "dp_delta", "count": <number of original states>,
+ *    "resolution": r, "yaw_resolution": ry,
+ *    "position_error": <achieved maximum position error>,
+ *    "yaw_error": <achieved maximum yaw error>,
+ *    "data": [x0, y0, yaw0, dx1, dy1, dyaw1, ...]}
+ * where the data are integers. Yaw angles are unwrapped before encoding, so
+ * the decoded angles have to be normalised to [-pi, pi].
+ * python/trajectory_codec.py decodes such trajectories.
+ *
+ * Enabled by global::settings.benchmark.trajectory_compression and applied to
+ * all logged trajectories by Log::logTrajectory().
+ */
+class TrajectoryCompression {
+ public:
+  TrajectoryCompression() = delete;
+
+  /**
+   * Returns the trajectory as it is to be logged, i.e. encoded if the
+   * compression is enabled, otherwise as an array of (x, y, yaw) states.
+   */
+  static nlohmann::json encode(
+      const std::vector<std::array<double, 3>> &trajectory);
+
+  /**
+   * Simplifies, quantises and delta-encodes the trajectory.
+   */
+  static nlohmann::json compress(
+      const std::vector<std::array<double, 3>> &trajectory,
+      double position_tolerance, double yaw_tolerance, double resolution,
+      double yaw_resolution);
+
+  /**
+   * Decodes a compressed trajectory into the retained (x, y, yaw) states,
+   * with the yaw angles left unwrapped.
+   */
+  static std::vector<std::array<double, 3>> decompress(
+      const nlohmann::json &encoded);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * Minimal checks for the test executables registered with CTest. A failed
+ * check is reported with its location, and main() returns the number of
+ * failed checks via test::result().
+ */
+namespace test {
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+inline int result() {
+  if (failures() == 0) std::printf("All checks passed.\n");
+  return failures() == 0 ? 0 : 1;
+}
+}  // namespace test
+
+#define CHECK(condition)                                               \
+  do {                                                                 \
+    if (!(condition)) {                                                \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,      \
+                   __LINE__, #condition);                              \
+      ++test::failures();                                              \
+    }                                                                  \
+  } while (false)
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TestUtils.h"
+#include "base/PlannerSettings.h"
+#include "steer_functions/BatchDistance.h"
+
+/**
+ * The SIMD kernels behind distanceMany() have to match the exact distances of
+ * the linear, Dubins and Reeds-Shepp state spaces, including the padded
+ * lanes of incomplete blocks and coincident states.
+ */
+int main() {
+  global::settings.env.createEnvironment();
+  global::settings.steer.distance_table.enabled = false;
+
+  for (const auto steering :
+       {Steering::STEER_TYPE_LINEAR, Steering::STEER_TYPE_DUBINS,
+        Steering::STEER_TYPE_REEDS_SHEPP}) {
+    global::settings.steer.steering_type = steering;
+    global::settings.steer.initializeSteering();
+    const auto &space = global::settings.ompl.state_space;
+    const auto *batch = dynamic_cast<const BatchDistance *>(space.get());
+    CHECK(batch != nullptr);
+    if (batch == nullptr) continue;
+
+    // not a multiple of the block size or the number of lanes
+    const std::size_t n = 2 * BatchDistance::BlockSize + 3;
+    auto sampler = space->allocDefaultStateSampler();
+    std::vector<ompl::base::State *> states(n);
+    for (auto *&state : states) {
+      state = space->allocState();
+      sampler->sampleUniform(state);
+    }
+    space->copyState(states[1], states[0]);
+
+    std::vector<double> distances(n);
+    for (std::size_t q = 0; q < 4; ++q) {
+      batch->distanceMany(states[q], states.data(), distances.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        const double exact = space->distance(states[q], states[i]);
+        CHECK(std::abs(distances[i] - exact) <=
+              1e-9 * std::max(1., exact));
+      }
+    }
+    for (auto *state : states) space->freeState(state);
+  }
+
+  return test::result();
+}
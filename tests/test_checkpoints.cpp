@@ -0,0 +1,40 @@
+#include "TestUtils.h"
+#include "base/PlannerSettings.h"
+#include "planners/OMPLPlanner.hpp"
+
+/**
+ * PRM evaluates the termination condition from several threads, each
+ * checkpoint nevertheless has to be recorded exactly once and in order.
+ * Checkpoints after the time limit record the final solution when the
+ * planner has stopped.
+ */
+int main() {
+  global::settings.env.createEnvironment();
+  global::settings.steer.initializeSteering();
+  global::settings.max_planning_time = .5;
+
+  const std::vector<double> checkpoints{.05, .1, .2, .3, 2., 3.};
+  for (int run = 0; run < 3; ++run) {
+    global::settings.environment->resetCollisionTimer();
+    global::settings.ompl.steering_timer.reset();
+    PRMPlanner planner;
+    planner.checkpoints = checkpoints;
+    planner.run();
+
+    CHECK(planner.checkpointSolutions.size() == checkpoints.size());
+    for (std::size_t i = 0; i < planner.checkpointSolutions.size(); ++i) {
+      const auto &checkpoint = planner.checkpointSolutions[i];
+      CHECK(checkpoint.time <= checkpoints[i]);
+      // the timers are read when the checkpoint is recorded
+      CHECK(checkpoint.collision_time >= 0);
+      CHECK(checkpoint.steering_time >= 0);
+      if (i > 0)
+        CHECK(planner.checkpointSolutions[i - 1].time <= checkpoint.time);
+    }
+    // both checkpoints after the time limit share the final solution
+    CHECK(planner.checkpointSolutions.back().time ==
+          planner.planningTime());
+  }
+
+  return test::result();
+}
@@ -0,0 +1,94 @@
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "TestUtils.h"
+#include "base/EnvironmentStore.h"
+#include "base/PlannerSettings.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+std::vector<unsigned char> fromBase64(const std::string &encoded) {
+  static const std::string alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> data;
+  std::uint32_t chunk = 0;
+  int bits = 0;
+  for (const char c : encoded) {
+    if (c == '=') break;
+    chunk = (chunk << 6) | (std::uint32_t)alphabet.find(c);
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      data.push_back((unsigned char)((chunk >> bits) & 0xffu));
+    }
+  }
+  return data;
+}
+
+nlohmann::json load(const fs::path &filename) {
+  std::ifstream stream(filename.string());
+  return nlohmann::json::parse(stream);
+}
+}  // namespace
+
+/**
+ * Stores grids in sidecar files next to the log file and reloads them.
+ */
+int main() {
+  const fs::path root = fs::temp_directory_path() / fs::unique_path();
+  global::settings.benchmark.log_file = (root / "a" / "log.json").string();
+
+  // 5 x 3 grid with an obstacle column
+  const std::string map = "001000010000100";
+  const std::vector<double> distances{2., 1., 0., 1., 2., 2., 1., 0.,
+                                      1., 2., 2., 1., 0., 1., 2.};
+  const auto reference = EnvironmentStore::store(map, 5, 3, distances);
+  CHECK(reference.is_object());
+  const std::string file = reference.value("file", "");
+  CHECK(file == "environments/" + reference.value("hash", "") + ".json");
+  const auto filename = root / "a" / file;
+  CHECK(fs::exists(filename));
+
+  // a map is only written once per directory
+  CHECK(EnvironmentStore::store(map, 5, 3, distances) == reference);
+  CHECK(fs::exists(filename) && fs::remove(filename));
+  CHECK(EnvironmentStore::store(map, 5, 3, distances) == reference);
+  CHECK(!fs::exists(filename));
+
+  // but once more after the log file has moved to another directory
+  global::settings.benchmark.log_file = (root / "b" / "log.json").string();
+  CHECK(EnvironmentStore::store(map, 5, 3, distances) == reference);
+  const auto moved = root / "b" / file;
+  CHECK(fs::exists(moved));
+
+  if (fs::exists(moved)) {
+    const auto j = load(moved);
+    CHECK(j["hash"] == reference["hash"]);
+    CHECK(j["width"] == 5 && j["height"] == 3);
+    const auto occupancy = fromBase64(j["map"]);
+    CHECK(occupancy.size() == (map.size() + 7) / 8);
+    for (std::size_t i = 0; i < map.size() && i / 8 < occupancy.size(); ++i)
+      CHECK(((occupancy[i / 8] >> (i % 8)) & 1u) == (map[i] == '1' ? 1u : 0u));
+    const auto halves = fromBase64(j["distances"]);
+    CHECK(halves.size() == distances.size() * 2);
+    for (std::size_t i = 0; i < distances.size() && 2 * i + 1 < halves.size();
+         ++i) {
+      const auto half = (std::uint16_t)(halves[2 * i] | halves[2 * i + 1] << 8);
+      CHECK(half == EnvironmentStore::toHalf((float)distances[i]));
+    }
+  }
+
+  // the hash depends on the content
+  CHECK(EnvironmentStore::store(map, 5, 3)["hash"] != reference["hash"]);
+  CHECK(EnvironmentStore::store(map, 3, 5, distances)["hash"] !=
+        reference["hash"]);
+
+  CHECK(EnvironmentStore::toHalf(1.f) == 0x3c00u);
+  CHECK(EnvironmentStore::toHalf(-2.f) == 0xc000u);
+  CHECK(EnvironmentStore::toHalf(.5f) == 0x3800u);
+  CHECK(EnvironmentStore::toHalf(65536.f) == 0x7c00u);
+
+  fs::remove_all(root);
+  return test::result();
+}
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TestUtils.h"
+#include "base/HeuristicTable.h"
+#include "base/PlannerSettings.h"
+#include "base/environments/GridMaze.h"
+
+namespace {
+constexpr double WallY = 10;
+// the gap cell covers the x-coordinates that round to it
+constexpr double GapMinX = 14.5, GapMaxX = 15.5;
+
+/**
+ * Lower bound on the length of any path from p to the goal, which has to
+ * cross the wall at y = WallY within the gap.
+ */
+double lowerBound(const Point &p, const Point &goal) {
+  const auto length = [&](double x) {
+    return std::hypot(p.x - x, p.y - WallY) +
+           std::hypot(goal.x - x, goal.y - WallY);
+  };
+  // the length is convex in x
+  double lo = GapMinX, hi = GapMaxX;
+  for (int i = 0; i < 100; ++i) {
+    const double a = lo + (hi - lo) / 3, b = hi - (hi - lo) / 3;
+    if (length(a) < length(b))
+      hi = b;
+    else
+      lo = a;
+  }
+  return length(lo);
+}
+}  // namespace
+
+/**
+ * The cost-to-go table has to remain a lower bound on the length of
+ * collision-free paths, in particular through a corridor of one cell that
+ * the footprint of GridMaze::occupied(x, y) nearly closes.
+ */
+int main() {
+  global::settings.env.heuristic.resolution = 1.;
+  // a wall across the map with a gap of one cell
+  auto maze = GridMaze::createFromObstacles(
+      {Rectangle(0, WallY, 15, WallY + 1), Rectangle(16, WallY, 30, WallY + 1)},
+      30, 20);
+  const Point goal(5, 15);
+  const auto table = HeuristicTable::get(*maze, goal);
+
+  // the goal is reachable through the gap, so the wall is taken into account
+  const Point start(5, 5);
+  CHECK(table->costToGo(start.x, start.y) >
+        std::hypot(start.x - goal.x, start.y - goal.y) + 1);
+
+  for (double x = 1.5; x < 29; x += .5) {
+    for (double y = 1.5; y < WallY - 1; y += .5) {
+      if (maze->collides(x, y)) continue;
+      const Point p(x, y);
+      CHECK(table->costToGo(x, y) <= lowerBound(p, goal) + 1e-6);
+    }
+  }
+
+  // tables are cached per environment content and goal
+  CHECK(HeuristicTable::get(*maze, goal) == table);
+  CHECK(HeuristicTable::get(*maze, Point(6, 15)) != table);
+  return test::result();
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "TestUtils.h"
+#include "planners/jps/JumpPointGrid.h"
+
+namespace {
+constexpr int Size = 48;
+
+bool validMove(const JumpPointGrid &grid, const JumpPointGrid::Cell &a,
+               const JumpPointGrid::Cell &b) {
+  const int dx = b.x - a.x, dy = b.y - a.y;
+  if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0))
+    return false;
+  // no corner cutting
+  return grid.free(b) &&
+         (dx == 0 || dy == 0 || (grid.free(a.x + dx, a.y) &&
+                                 grid.free(a.x, a.y + dy)));
+}
+
+/**
+ * Length of the shortest 8-connected path without corner cutting, computed
+ * by Dijkstra's algorithm, or infinity if the goal cannot be reached.
+ */
+double shortestPath(const JumpPointGrid &grid, const JumpPointGrid::Cell &start,
+                    const JumpPointGrid::Cell &goal) {
+  std::vector<double> cost(Size * Size,
+                           std::numeric_limits<double>::infinity());
+  typedef std::pair<double, int> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  cost[start.y * Size + start.x] = 0;
+  open.emplace(0., start.y * Size + start.x);
+  while (!open.empty()) {
+    const auto [c, index] = open.top();
+    open.pop();
+    if (c > cost[index]) continue;
+    const JumpPointGrid::Cell cell(index % Size, index / Size);
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        const JumpPointGrid::Cell next(cell.x + dx, cell.y + dy);
+        if (!validMove(grid, cell, next)) continue;
+        const double next_cost = c + std::hypot(dx, dy);
+        if (next_cost < cost[next.y * Size + next.x]) {
+          cost[next.y * Size + next.x] = next_cost;
+          open.emplace(next_cost, next.y * Size + next.x);
+        }
+      }
+    }
+  }
+  return cost[goal.y * Size + goal.x];
+}
+
+/**
+ * Checks that the path connects start and goal by valid moves and returns
+ * its length.
+ */
+double pathLength(const JumpPointGrid &grid,
+                  const std::vector<JumpPointGrid::Cell> &path,
+                  const JumpPointGrid::Cell &start,
+                  const JumpPointGrid::Cell &goal) {
+  CHECK(!path.empty() && path.front() == start && path.back() == goal);
+  double length = 0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    CHECK(validMove(grid, path[i - 1], path[i]));
+    length += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+  }
+  return length;
+}
+}  // namespace
+
+/**
+ * Jump Point Search, with and without the JPS+ jump table, has to find paths
+ * as short as those of a plain A* search on random grids.
+ */
+int main() {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> coordinate(0, Size - 1);
+  for (int map = 0; map < 40; ++map) {
+    const double obstacle_ratio = .1 + .01 * map;
+    std::bernoulli_distribution obstacle(obstacle_ratio);
+    std::vector<unsigned char> occupied(Size * Size);
+    for (auto &o : occupied) o = obstacle(rng);
+
+    const JumpPointGrid jps(0, 0, 1, Size, Size, occupied, false);
+    const JumpPointGrid jps_plus(0, 0, 1, Size, Size, occupied, true);
+    CHECK(jps_plus.hasJumpTable());
+
+    for (int query = 0; query < 20; ++query) {
+      const JumpPointGrid::Cell start(coordinate(rng), coordinate(rng));
+      const JumpPointGrid::Cell goal(coordinate(rng), coordinate(rng));
+      if (!jps.free(start) || !jps.free(goal)) continue;
+      const double optimal = shortestPath(jps, start, goal);
+
+      for (const auto *grid : {&jps, &jps_plus}) {
+        std::vector<JumpPointGrid::Cell> path;
+        unsigned int expansions;
+        const bool found = grid->search(start, goal, path, 10., expansions);
+        CHECK(found == std::isfinite(optimal));
+        if (found && std::isfinite(optimal))
+          CHECK(std::abs(pathLength(*grid, path, start, goal) - optimal) <
+                1e-6);
+      }
+    }
+  }
+  return test::result();
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TestUtils.h"
+#include "utils/TrajectoryCompression.h"
+
+namespace {
+constexpr double PositionTolerance = .05, YawTolerance = .05;
+constexpr double Resolution = 1e-3, YawResolution = 1e-3;
+
+/**
+ * Distance of point p to the polyline through the (x, y) states.
+ */
+double polylineDistance(const std::array<double, 3> &p,
+                        const std::vector<std::array<double, 3>> &polyline) {
+  double distance = HUGE_VAL;
+  for (std::size_t i = 0; i + 1 < polyline.size(); ++i) {
+    const auto &a = polyline[i], &b = polyline[i + 1];
+    const double dx = b[0] - a[0], dy = b[1] - a[1];
+    const double length2 = dx * dx + dy * dy;
+    double t = 0;
+    if (length2 > 0)
+      t = std::clamp(((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / length2, 0.,
+                     1.);
+    distance = std::min(
+        distance, std::hypot(p[0] - (a[0] + t * dx), p[1] - (a[1] + t * dy)));
+  }
+  return distance;
+}
+
+double angleDifference(double a, double b) {
+  return std::abs(std::remainder(a - b, 2. * M_PI));
+}
+}  // namespace
+
+/**
+ * Round trip of a densely interpolated trajectory (a straight segment
+ * followed by several turns, so that the yaw angle wraps around) through
+ * the compression and decompression.
+ */
+int main() {
+  std::vector<std::array<double, 3>> trajectory;
+  for (int i = 0; i < 200; ++i) trajectory.push_back({i * .05, 0., 0.});
+  const double radius = 2.;
+  for (int i = 1; i <= 1000; ++i) {
+    const double angle = i * .02;
+    trajectory.push_back({10. + radius * std::sin(angle),
+                          radius - radius * std::cos(angle),
+                          std::remainder(angle, 2. * M_PI)});
+  }
+
+  const auto encoded = TrajectoryCompression::compress(
+      trajectory, PositionTolerance, YawTolerance, Resolution, YawResolution);
+  CHECK(encoded["encoding"] == "dp_delta");
+  CHECK(encoded["count"] == trajectory.size());
+  // the achieved errors include the quantisation
+  CHECK(encoded["position_error"].get<double>() <=
+        PositionTolerance + Resolution);
+  CHECK(encoded["yaw_error"].get<double>() <= YawTolerance + YawResolution);
+
+  const auto decoded = TrajectoryCompression::decompress(encoded);
+  CHECK(decoded.size() >= 2);
+  CHECK(decoded.size() < trajectory.size() / 10);
+
+  // the first and last states are retained
+  const auto &first = trajectory.front(), &last = trajectory.back();
+  CHECK(std::hypot(decoded.front()[0] - first[0],
+                   decoded.front()[1] - first[1]) <= Resolution);
+  CHECK(angleDifference(decoded.front()[2], first[2]) <= YawResolution);
+  CHECK(std::hypot(decoded.back()[0] - last[0], decoded.back()[1] - last[1]) <=
+        Resolution);
+  CHECK(angleDifference(decoded.back()[2], last[2]) <= YawResolution);
+
+  for (const auto &state : trajectory)
+    CHECK(polylineDistance(state, decoded) <= PositionTolerance + Resolution);
+
+  // the encoding is deterministic
+  CHECK(TrajectoryCompression::compress(trajectory, PositionTolerance,
+                                        YawTolerance, Resolution,
+                                        YawResolution) == encoded);
+
+  // short trajectories are retained entirely
+  const std::vector<std::array<double, 3>> segment{{1., 2., 3.},
+                                                   {4., 5., -3.}};
+  const auto short_decoded =
+      TrajectoryCompression::decompress(TrajectoryCompression::compress(
+          segment, PositionTolerance, YawTolerance, Resolution,
+          YawResolution));
+  CHECK(short_decoded.size() == 2);
+  for (std::size_t i = 0; i < segment.size() && i < short_decoded.size(); ++i) {
+    CHECK(std::abs(short_decoded[i][0] - segment[i][0]) <= Resolution);
+    CHECK(std::abs(short_decoded[i][1] - segment[i][1]) <= Resolution);
+    CHECK(angleDifference(short_decoded[i][2], segment[i][2]) <=
+          YawResolution);
+  }
+
+  return test::result();
+}